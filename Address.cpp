@@ -0,0 +1,28 @@
+/*-- Address.cpp ------------------------------------------------------------
+   This file implements binary wallet address member functions.
+-----------------------------------------------------------------------------*/
+#include "Address.h"
+
+bool Address::isNull() const {
+    return std::ranges::all_of(bytes, [](const unsigned char b) { return b == 0; });
+}
+
+std::string Address::toString() const {
+    return PREFIX + util::base58check_encode(bytes.data(), bytes.size());
+}
+
+bool Address::fromString(const std::string& str, Address& out) {
+    if (str.size() <= PREFIX.size() || str.compare(0, PREFIX.size(), PREFIX) != 0) {
+        util::logCall("ADDRESS", "fromString()", false, "Missing Address Prefix");
+        return false;
+    }
+
+    std::vector<unsigned char> payload;
+    if (!util::base58check_decode(str.substr(PREFIX.size()), payload) || payload.size() != SIZE) {
+        util::logCall("ADDRESS", "fromString()", false, "Invalid Address Encoding");
+        return false;
+    }
+
+    std::memcpy(out.bytes.data(), payload.data(), SIZE);
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef ADDRESS
+#define ADDRESS
+
+#include "util.h"
+#include <array>
+
+/*-- Address.h ---------------------------------------------------------------
+
+  This header file defines the binary wallet address used by this project.
+  An address is the 20 byte RIPEMD-160 digest of the SHA3-512 hashed public
+  key. It is carried in this fixed width form internally and on the wire,
+  so comparing two addresses is a single 20 byte memcmp.
+
+  Basic operations are:
+	 toString:    "Ox17" + Base58Check(bytes), used at the CLI boundary only
+	 fromString:  Parses & checksum-verifies the CLI form back into bytes
+	 isNull:      True for the all zero address (genesis / placeholder)
+
+Note:
+  Base58 is never used below the CLI, the network only sees raw bytes.
+-------------------------------------------------------------------------*/
+
+struct Address
+{
+	static constexpr size_t SIZE = 20;
+	inline static const std::string PREFIX = "Ox17";
+
+	std::array<unsigned char, SIZE> bytes{};
+
+	Address() = default;
+	explicit Address(const unsigned char* data) { std::memcpy(bytes.data(), data, SIZE); }
+
+	bool isNull() const;
+	std::string toString() const;
+	static bool fromString(const std::string& str, Address& out);
+
+	bool operator==(const Address& other) const {
+		return std::memcmp(bytes.data(), other.bytes.data(), SIZE) == 0;
+	}
+	bool operator<(const Address& other) const {
+		return std::memcmp(bytes.data(), other.bytes.data(), SIZE) < 0;
+	}
+};
+
+/* Addresses are digests, so their leading bytes already hash well */
+struct AddressHash
+{
+	size_t operator()(const Address& a) const noexcept {
+		size_t h = 0;
+		std::memcpy(&h, a.bytes.data(), sizeof(h));
+		return h;
+	}
+};
+
+#endif
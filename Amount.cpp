@@ -0,0 +1,109 @@
+/*-- Amount.cpp ---------------------------------------------------------------
+   This file implements fixed point amount member functions.
+-----------------------------------------------------------------------------*/
+#include "Amount.h"
+#include <cmath>
+
+bool Amounts::add(const Amount a, const Amount b, Amount& out) {
+    Amount r;
+    if (__builtin_add_overflow(a, b, &r) || !inRange(r)) {
+        return false;
+    }
+    out = r;
+    return true;
+}
+
+bool Amounts::sub(const Amount a, const Amount b, Amount& out) {
+    Amount r;
+    if (__builtin_sub_overflow(a, b, &r) || !inRange(r)) {
+        return false;
+    }
+    out = r;
+    return true;
+}
+
+bool Amounts::sum(std::span<const Amount> amounts, Amount& out) {
+    /* BLOCK * MAX_MONEY < INT64_MAX, so a block total cannot overflow */
+    constexpr size_t BLOCK = 64;
+    static_assert(static_cast<unsigned __int128>(BLOCK) * MAX_MONEY < static_cast<unsigned __int128>(INT64_MAX));
+
+    Amount total = 0;
+    size_t i = 0;
+    const size_t n = amounts.size();
+    while (i < n) {
+        const size_t end = std::min(n, i + BLOCK);
+        /* Summed unsigned: an out of range value may wrap the block total, but never overflows a signed
+           int64 (UB), & the block is rejected for it anyway */
+        uint64_t part = 0;
+        uint64_t bad = 0;
+        for (size_t j = i; j < end; j++) {
+            const uint64_t v = static_cast<uint64_t>(amounts[j]);
+            bad |= v > static_cast<uint64_t>(MAX_MONEY); // negatives wrap high
+            part += v;
+        }
+        if (bad || !add(total, static_cast<Amount>(part), total)) {
+            return false;
+        }
+        i = end;
+    }
+
+    out = total;
+    return true;
+}
+
+bool Amounts::fromCoins(const double coins, Amount& out) {
+    if (!std::isfinite(coins) || coins < 0 || coins > static_cast<double>(MAX_MONEY / COIN_UNITS)) {
+        return false;
+    }
+    out = std::llround(coins * static_cast<double>(COIN_UNITS));
+    return inRange(out);
+}
+
+bool Amounts::parse(const std::string& str, Amount& out) {
+    /* Exact decimal parse, at most 8 fractional digits */
+    Amount whole = 0, frac = 0;
+    size_t i = 0, fracDigits = 0;
+    bool digits = false, dot = false;
+    for (; i < str.size(); i++) {
+        const char c = str[i];
+        if (c == '.' && !dot) {
+            dot = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        digits = true;
+        if (dot) {
+            if (++fracDigits > 8) {
+                return false;
+            }
+            frac = frac * 10 + (c - '0');
+        }
+        else {
+            whole = whole * 10 + (c - '0');
+            if (whole > MAX_MONEY / COIN_UNITS) {
+                return false;
+            }
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    for (; fracDigits < 8; fracDigits++) {
+        frac *= 10;
+    }
+    return add(whole * COIN_UNITS, frac, out);
+}
+
+std::string Amounts::toString(const Amount a) {
+    const bool neg = a < 0;
+    const uint64_t mag = neg ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    std::string frac = std::to_string(mag % COIN_UNITS);
+    frac.insert(0, 8 - frac.size(), '0');
+    return (neg ? "-" : "") + std::to_string(mag / COIN_UNITS) + "." + frac;
+}
+
+double Amounts::toCoins(const Amount a) {
+    return static_cast<double>(a) / static_cast<double>(COIN_UNITS);
+}
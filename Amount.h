@@ -0,0 +1,53 @@
+#ifndef AMOUNT
+#define AMOUNT
+
+#include "util.h"
+#include <span>
+
+/*-- Amount.h -----------------------------------------------------------------
+
+  This header file defines the monetary type used by this project.
+  Amounts, fees, rewards and balances are whole numbers of base units
+  (1 coin = COIN_UNITS base units) held in a signed 64-bit integer, so that
+  accounting is exact and every addition can be checked for overflow.
+
+  Basic operations are:
+	 add / sub:   Checked arithmetic, false on overflow or out of range
+	 sum:         Checked total of a contiguous run of amounts
+	 fromCoins:   Converts a coin value (CLI / config) into base units
+	 parse:       Parses a decimal coin string ("12.5") exactly
+	 toString:    Formats base units as a decimal coin string
+
+Note:
+  sum() adds fixed size blocks with plain integer adds and checks ranges
+  with a branch free OR, so the compiler can keep the inner loop in SIMD
+  registers. Blocks are small enough that they can never overflow, only
+  the per block carry into the running total is checked.
+-------------------------------------------------------------------------*/
+
+using Amount = int64_t;
+
+class Amounts
+{
+public:
+	static constexpr Amount COIN_UNITS = 100000000;
+	static constexpr Amount MAX_MONEY = 1000000000 * COIN_UNITS;
+
+	/* True for 0 <= a <= MAX_MONEY */
+	static constexpr bool inRange(const Amount a) { return a >= 0 && a <= MAX_MONEY; }
+
+	/* Checked arithmetic, out is only written on success */
+	static bool add(Amount a, Amount b, Amount& out);
+	static bool sub(Amount a, Amount b, Amount& out);
+
+	/* Checked total of contiguous amounts */
+	static bool sum(std::span<const Amount> amounts, Amount& out);
+
+	/* Conversions at the CLI / config boundary */
+	static bool fromCoins(double coins, Amount& out);
+	static bool parse(const std::string& str, Amount& out);
+	static std::string toString(Amount a);
+	static double toCoins(Amount a);
+};
+
+#endif
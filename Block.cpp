@@ -18,8 +18,21 @@ Block::Block(const std::vector<transactions>& d, std::vector<unsigned char> prev
     util::logCall("BLOCK", "Block()", true);
 }
 
+Block::Block(const std::vector<transactions>& d, std::vector<unsigned char> merkleRoot, std::vector<unsigned char> prevHash,
+    float versionNum, unsigned int blockHeight, unsigned long long ts, std::vector<unsigned char> snapshotDigest)
+    : data(d),
+    head(ts, std::move(prevHash), versionNum, std::move(merkleRoot), std::move(snapshotDigest)),
+    blockHeight(blockHeight),
+    blockSize(setSize()),
+    currHash(setCurrHash())
+{
+    next = nullptr;
+    util::logCall("BLOCK", "Block()", true);
+}
+
 Block::Block(const Block& copy)
     :data(copy.data),
+    pruned(copy.pruned),
     head(copy.head),
     blockHeight(copy.blockHeight),
     currHash(copy.currHash),
@@ -34,44 +47,18 @@ float Block::getVersion() const {
 
 /* Merkle root of transactions */
 
-std::vector<unsigned char> Block::MerkleRoot(const std::vector<transactions>& tx) const {
-    /* Compute hashes for each transaction */
-    std::vector<std::vector<unsigned char>> txHash;
-    for (const auto& elem : tx) {
-        std::string txHashStr(reinterpret_cast<char*>(elem.serialize().get()));
-        if (std::vector<unsigned char> hash; util::shaHash(txHashStr, hash)) {
-            txHash.emplace_back(std::move(hash));
-        }
-        else {
-            std::cerr << "Failed to hash tx" << std::endl;
-            return {};
-        }
-    }
-
-    /* Ensure even number of hashes */
-    if (txHash.size() % 2 != 0) {
-        txHash.emplace_back(txHash.back());
+std::vector<unsigned char> Block::MerkleRoot(const std::vector<transactions>& tx) {
+    if (tx.empty()) {
+        return {};
     }
 
-    /* Compute the Merkle root */
-    while (txHash.size() > 1) {
-        std::vector<std::vector<unsigned char>> newLevel;
-        for (size_t i = 0; i < txHash.size(); i += 2) {
-            // Convert hashes to a single string for hashing
-            std::string combinedHashStr(txHash[i].begin(), txHash[i].end());
-            combinedHashStr.append(txHash[i + 1].begin(), txHash[i + 1].end());
-
-            if (std::vector<unsigned char> newHash; util::shaHash(combinedHashStr, newHash)) {
-                newLevel.emplace_back(std::move(newHash));
-            } else {
-                std::cerr << "Failed to hash combined data" << std::endl;
-                return {};
-            }
-        }
-        txHash = newLevel;
+    /* Leaves are txids, already computed for every transaction */
+    MerkleBuilder body;
+    for (size_t i = 1; i < tx.size(); i++) {
+        body.append(MerkleBuilder::leaf(tx[i]));
     }
 
-    return txHash.front(); // Final Merkle Root
+    return MerkleBuilder::blockRoot(MerkleBuilder::leaf(tx.front()), body.root());
 }
 
 std::vector<unsigned char> Block::getMerkleRoot() const {
@@ -91,64 +78,51 @@ unsigned int Block::getBlockHeight() const {
 }
 
 std::vector<unsigned char> Block::setCurrHash() const{
+    return headHash(getTimestamp(), getPrevHash(), getVersion(), getMerkleRoot(), getBlockHeight(), getSize(), head.snapshotDigest);
+}
 
-    /* Block data used for current hash:clear
-     * Data & Timestamp
-     * Prev Hash & Version
-     * Merkle, Height & Size
-     */
+std::vector<unsigned char> Block::getSnapshotDigest() const {
+    return head.snapshotDigest;
+}
 
-    /* Data */
-    size_t tSize = 0;
-    /* Get Size of Each Transaction */
-    for (const auto& tx : data) {
-        size_t temp_size = 0;
-        const std::unique_ptr<unsigned char[]> tdata = tx.serialize();
-        std::memcpy(&temp_size, tdata.get(), sizeof(size_t));
-        tSize += temp_size;
-    }
+std::vector<unsigned char> Block::headHash(const unsigned long long t_ts, const std::vector<unsigned char>& t_hash,
+    const float t_v, const std::vector<unsigned char>& t_merkle, const unsigned int t_height, const size_t t_bsize,
+    const std::vector<unsigned char>& t_snap) {
 
-    tSize += sizeof(unsigned long long) + sizeof(float) + sizeof(unsigned int) + sizeof(size_t);
-    const std::vector<unsigned char> t_hash = getPrevHash();
-    const std::vector<unsigned char> t_merkle = getMerkleRoot();
-    tSize += (t_hash.size() * sizeof(unsigned char)) + (t_merkle.size() * sizeof(unsigned char));
+    /* Block data used for current hash:
+     * Timestamp, Prev Hash & Version
+     * Merkle (commits to Data), Height & Size
+     * Snapshot digest, only when committed so other heads hash as before
+     */
+    size_t tSize = sizeof(unsigned long long) + sizeof(float) + sizeof(unsigned int) + sizeof(size_t);
+    tSize += (t_hash.size() * sizeof(unsigned char)) + (t_merkle.size() * sizeof(unsigned char)) + t_snap.size();
 
-    /* Add Each Transaction to Hash Data */
     std::unique_ptr<unsigned char[]> h_data (new unsigned char[tSize]);
-    size_t offset = 0;
-    for (const auto& tx : data) {
-        size_t temp_size2 = 0;
-        const std::unique_ptr<unsigned char[]> tdata2 = tx.serialize();
-        std::memcpy(&temp_size2, tdata2.get(), sizeof(size_t));
-        std::memcpy(h_data.get() + offset, tdata2.get(), temp_size2);
-        offset += temp_size2;
-    }
-
-    /* Add All other data */
-    size_t offset2 = offset;
-    const unsigned long long t_ts = getTimestamp();
+    size_t offset2 = 0;
     std::memcpy(h_data.get() + offset2, &t_ts, sizeof(unsigned long long));
     offset2 += sizeof(unsigned long long);
 
     std::memcpy(h_data.get() + offset2, t_hash.data(), (t_hash.size() * sizeof(uint8_t)));
     offset2 += (t_hash.size() * sizeof(uint8_t));
 
-    const float t_v = getVersion();
     std::memcpy(h_data.get() + offset2, &t_v, sizeof(float));
     offset2 += sizeof(float);
 
     std::memcpy(h_data.get() + offset2, t_merkle.data(), (t_merkle.size() * sizeof(uint8_t)));
     offset2 += (t_merkle.size() * sizeof(uint8_t));
 
-    const unsigned int t_height = getBlockHeight();
     std::memcpy(h_data.get() + offset2, &t_height, sizeof(unsigned int));
     offset2 += sizeof(unsigned int);
 
-    const size_t t_bsize = getSize();
     std::memcpy(h_data.get() + offset2, &t_bsize, sizeof(size_t));
+    offset2 += sizeof(size_t);
 
-    // tdata remains
-    std::string msg(reinterpret_cast<char*>(h_data.get()));
+    if (!t_snap.empty()) {
+        std::memcpy(h_data.get() + offset2, t_snap.data(), t_snap.size());
+    }
+
+    /* Explicit length, the head holds zero bytes */
+    std::string msg(reinterpret_cast<char*>(h_data.get()), tSize);
     std::vector<unsigned char> hash;
     if (util::shaHash(msg, hash)) {
         return hash;
@@ -176,6 +150,15 @@ std::vector<transactions> Block::getData() const {
     return data;
 }
 
+void Block::prune() {
+    std::vector<transactions>().swap(data); // clear() keeps the capacity
+    pruned = true;
+}
+
+bool Block::isPruned() const {
+    return pruned;
+}
+
 
 size_t Block::setSize() const{
     size_t size = 0;
@@ -205,183 +188,81 @@ void Block::display() {
 
 /* Serialize method */
 std::unique_ptr<unsigned char[]> Block::serialize() const {
+    return Wire::encode(*this);
+}
 
-    /* Collect Total Sizes*/
-    size_t tSize = 0; // total size
-    /* Predetermined Sizes:  tSize, timestamp, version, blk height & blk size */
-    tSize += sizeof(size_t) + sizeof(unsigned long long) + sizeof(float) + sizeof(unsigned int) + sizeof(size_t);
-
-    size_t phSize = head.prevHash.size(); // previous hash size
-    size_t mrSize = head.merkleRoot.size(); // merkle root size
-    size_t chSize = currHash.size(); // current hash size
-
-    /* collect total size of data vector & total vector */
-    size_t dSize = 0;
-    size_t doffset = 0;
-    std::vector<unsigned char> tData;
-    for (auto& tx: data) {
-        std::unique_ptr<unsigned char[]> temp = tx.serialize();
-        size_t tempSize = 0;
-        std::memcpy(&tempSize, temp.get(), sizeof(size_t));
-        dSize += tempSize;
-        tData.resize(tData.size() + tempSize);
-        std::memcpy(tData.data() + doffset, temp.get(), tempSize);
-        doffset += tempSize;
-        temp = nullptr;
+/* Deserialize method
+* Current Has And Merkle Root Checks for Integrity
+*/
+Block* Block::deserialize(const std::unique_ptr<unsigned char[]>& buffer) {
+    if (!buffer) {
+        return nullptr;
     }
+    size_t tSize = 0;
+    std::memcpy(&tSize, buffer.get(), sizeof(size_t));
+    return deserialize(buffer.get(), tSize);
+}
 
-    /* Calculate Total Size & create buffer */
-    tSize += sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-    tSize += phSize + mrSize + chSize + dSize;
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    size_t offset = 0;
-
-    /* Serialize Block */
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(size_t)); //tSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, &phSize, sizeof(size_t)); //phSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, &mrSize, sizeof(size_t)); //mrSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, &chSize, sizeof(size_t)); //chSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, &dSize, sizeof(size_t)); //dSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, &head.timestamp, sizeof(unsigned long long)); //timestamp
-    offset += sizeof(unsigned long long);
-
-    std::memcpy(buffer.get() + offset, &head.versionNum, sizeof(float)); //version
-    offset += sizeof(float);
-
-    std::memcpy(buffer.get() + offset, &blockHeight, sizeof(unsigned int)); //BlockHeight
-    offset += sizeof(unsigned int);
-
-    std::memcpy(buffer.get() + offset, &blockSize, sizeof(size_t)); //blockSize
-    offset += sizeof(size_t);
-
-    std::memcpy(buffer.get() + offset, head.prevHash.data(), phSize); //prevHash
-    offset += phSize;
+Block* Block::deserialize(const unsigned char* buffer, const size_t size) {
+    Envelope env;
+    if (!decodeEnvelope(buffer, size, env)) {
+        return nullptr;
+    }
 
-    std::memcpy(buffer.get() + offset, head.merkleRoot.data(), mrSize); //merkleRoot
-    offset += mrSize;
+    std::vector<transactions> data;
+    data.reserve(env.txs.size());
+    for (const auto& tx : env.txs) {
+        std::optional<transactions> decoded;
+        if (!transactions::decode(tx, decoded)) {
+            return nullptr;
+        }
+        data.push_back(std::move(*decoded));
+    }
 
-    std::memcpy(buffer.get() + offset, currHash.data(), chSize); //currHash
-    offset += chSize;
+    return seal(env, data, MerkleRoot(data));
+}
 
-    std::memcpy(buffer.get() + offset, tData.data(), dSize); //data
+/* Envelope decode
+* Bounds checks the head & splits out every transaction's bytes, nothing is hashed here
+*/
+bool Block::decodeEnvelope(const unsigned char* buffer, const size_t size, Envelope& env) {
+    Wire::Decoded d;
+    if (!Wire::decode(std::span<const uint8_t>(buffer, size), d)) {
+        util::logCall("BLOCK", "deserialize()", false, "Malformed Block");
+        return false;
+    }
 
-    return buffer;
+    env.timestamp = Wire::at<&Block::head, &Head::timestamp>(d);
+    env.versionNum = Wire::at<&Block::head, &Head::versionNum>(d);
+    env.blockHeight = Wire::at<&Block::blockHeight>(d);
+    env.blockSize = Wire::at<&Block::blockSize>(d);
+    env.prevHash = std::move(Wire::at<&Block::head, &Head::prevHash>(d));
+    env.merkleRoot = std::move(Wire::at<&Block::head, &Head::merkleRoot>(d));
+    env.currHash = std::move(Wire::at<&Block::currHash>(d));
+    env.snapshotDigest = std::move(Wire::at<&Block::head, &Head::snapshotDigest>(d));
+    env.txs = std::move(Wire::at<&Block::data>(d));
+    return true;
 }
 
-/* Deserialize method
-* Current Has And Merkle Root Checks for Integrity
+/* Seal
+* Current Hash, Merkle Root & Size Checks against what the envelope claimed
 */
-Block* Block::deserialize(const std::unique_ptr<unsigned char[]>& buffer) const {
-    size_t offset = 0;
-
-    /* Deserialize total Size */
-    size_t tSize = 0;
-    std::memcpy(&tSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize phSize */
-    size_t phSize = 0;
-    std::memcpy(&phSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize mrSize */
-    size_t mrSize = 0;
-    std::memcpy(&mrSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize chSize */
-    size_t chSize = 0;
-    std::memcpy(&chSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize dSize */
-    size_t dSize = 0;
-    std::memcpy(&dSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize timestamp */
-    unsigned long long timestamp = 0;
-    std::memcpy(&timestamp, buffer.get() + offset, sizeof(unsigned long long));
-    offset += sizeof(unsigned long long);
-
-    /* Deserialize version */
-    float versionNum = 0;
-    std::memcpy(&versionNum, buffer.get() + offset, sizeof(float));
-    offset += sizeof(float);
-
-    /* Deserialize block Heigt */
-    unsigned int blockHeight = 0;
-    std::memcpy(&blockHeight, buffer.get() + offset, sizeof(unsigned int));
-    offset += sizeof(unsigned int);
-
-    /* Deserialize block size */
-    size_t blockSize = 0;
-    std::memcpy(&blockSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize previous hash itself */
-    std::vector<unsigned char> prevHash(phSize);
-    std::memcpy(prevHash.data(), buffer.get() + offset, phSize);
-    offset += phSize;
-
-    /* Deserialize merkle root itself */
-    std::vector<unsigned char> merkleRoot(mrSize);
-    std::memcpy(merkleRoot.data(), buffer.get() + offset, mrSize);\
-    offset += mrSize;
-
-    /* Deserialize merkle root itself */
-    std::vector<unsigned char> currHash(chSize);
-    std::memcpy(currHash.data(), buffer.get() + offset, chSize);
-    offset += chSize;
-
-    /* Deserialize Data */
-    size_t doff = 0;
-    std::vector<transactions> data;
-    std::unique_ptr<unsigned char[]> temp_data(new unsigned char[dSize]);
-    std::memcpy(temp_data.get(), buffer.get() + offset, dSize);
-
-    while (doff < dSize) {
-        size_t si = 0;
-        std::memcpy(&si, temp_data.get() + doff, sizeof(size_t));
-        std::unique_ptr<unsigned char[]> t_data(new unsigned char[si]);
-        std::memcpy(t_data.get(), temp_data.get() + doff, si);
-        data.emplace_back(transactions::deserialize(std::move(t_data)));
-        t_data = nullptr;
-        doff += si;
+Block* Block::seal(Envelope& env, const std::vector<transactions>& data, std::vector<unsigned char> merkleRoot) {
+    if (merkleRoot != env.merkleRoot) {
+        util::logCall("BLOCK", "deserialize()", false, "Merkle Root Does Not Match");
+        return nullptr;
     }
 
-
     // Create and populate Block
-    Block* block = new Block(data, std::move(prevHash), versionNum, blockHeight, timestamp);
-
-    /* Current Hash & Merkle Root Equality Check */
-    size_t newBlockSiz = block->getSize();
-    std::vector<unsigned char> newCurrHs = block->getCurrHash();
-    std::vector<unsigned char> newMerk = block->getMerkleRoot();
+    Block* block = new Block(data, std::move(merkleRoot), std::move(env.prevHash), env.versionNum, env.blockHeight,
+        env.timestamp, std::move(env.snapshotDigest));
 
-    if (newMerk == merkleRoot && newCurrHs == currHash) {
-        if (newBlockSiz == blockSize) {
-            return block;
-        }
-        else {
-            util::logCall("BLOCK", "deserialize()", false, "Block Size Does Not Match");
-            std::cout << "Block Size Does Not Match\n";
-            return nullptr;
-        }
-    }
-    else {
-        util::logCall("BLOCK", "deserialize()", false, "Block Size Does Not Match");
-        std::cout << "Block Size Does Not Match\n";
-        return nullptr;
+    if (block->getCurrHash() == env.currHash && block->getSize() == env.blockSize) {
+        return block;
     }
-}
\ No newline at end of file
+
+    util::logCall("BLOCK", "deserialize()", false, "Block Size Does Not Match");
+    std::cout << "Block Size Does Not Match\n";
+    delete block;
+    return nullptr;
+}
@@ -12,16 +12,19 @@
 
 Note:
   AI Will be a Major Future Focus in this class like all other classes
-  All Member Vars w/ Exception next are Constant for added Integrity!
+  All Member Vars w/ Exception next & data are Constant for added Integrity!
+  data is only ever emptied, by prune() on a pruned node
 -------------------------------------------------------------------------*/
 #include "util.h"
 #include "transactions.h"
+#include "Merkle.h"
 #include <cstddef>
 
 class Block {
 private:
-	/* Block basic data */
-	const std::vector<transactions> data;
+	/* Block basic data, released by prune() once the chain state holds its effects */
+	std::vector<transactions> data;
+	bool pruned = false;
 	static util utility;
 
 	/* Block Head, Struct assembled */
@@ -39,9 +42,13 @@ private:
 		/* Merkle Root of transactions */
 		const std::vector<unsigned char> merkleRoot;
 
+		/* Digest of a state snapshot this block commits to, empty for most blocks */
+		const std::vector<unsigned char> snapshotDigest;
+
 		// Constructor to initialize all const members
-		Head(unsigned long long ts, std::vector<unsigned char> prev, float ver, std::vector<unsigned char> merkle)
-			: timestamp(ts), prevHash(std::move(prev)), versionNum(ver), merkleRoot(std::move(merkle)) {
+		Head(unsigned long long ts, std::vector<unsigned char> prev, float ver, std::vector<unsigned char> merkle,
+			std::vector<unsigned char> snapshot = {})
+			: timestamp(ts), prevHash(std::move(prev)), versionNum(ver), merkleRoot(std::move(merkle)), snapshotDigest(std::move(snapshot)) {
 		}
 	};
 
@@ -53,11 +60,26 @@ private:
 	const size_t blockSize;
 	const std::vector<unsigned char> currHash;
 
+	/* Wire layout: tSize | region sizes | scalars | hashes | txs, each tx size prefixed */
+	using Wire = serial::Layout<Block,
+		serial::Extent<&Block::head, &Head::prevHash>, serial::Extent<&Block::head, &Head::merkleRoot>,
+		serial::Extent<&Block::currHash>, serial::Extent<&Block::data>,
+		serial::Extent<&Block::head, &Head::snapshotDigest>,
+		serial::Field<&Block::head, &Head::timestamp>, serial::Field<&Block::head, &Head::versionNum>,
+		serial::Field<&Block::blockHeight>, serial::Field<&Block::blockSize>,
+		serial::Field<&Block::head, &Head::prevHash>, serial::Field<&Block::head, &Head::merkleRoot>,
+		serial::Field<&Block::currHash>, serial::Field<&Block::head, &Head::snapshotDigest>,
+		serial::FieldAs<serial::Seq<serial::Framed<transactions>>, &Block::data>>;
+
 public:
 	/* Constructor Ran on Block Creation */
 	Block(const std::vector<transactions>& d, std::vector<unsigned char> prevHash, float versionNum, unsigned int blockHeight,
 		unsigned long long ts = setTimestamp(), Block* n = nullptr);
 
+	/* Constructor with a Merkle root already built (block templates), optionally committing to a state snapshot */
+	Block(const std::vector<transactions>& d, std::vector<unsigned char> merkleRoot, std::vector<unsigned char> prevHash,
+		float versionNum, unsigned int blockHeight, unsigned long long ts, std::vector<unsigned char> snapshotDigest = {});
+
 	/* Copy Constructor */
 	Block(const Block& copy);
 
@@ -79,14 +101,39 @@ public:
 
 	/* Merkle root of transactions */
 	std::vector<unsigned char> getMerkleRoot() const;
-	std::vector<unsigned char> MerkleRoot(const std::vector<transactions>& tx) const;
+	static std::vector<unsigned char> MerkleRoot(const std::vector<transactions>& tx);
+
+	/* Committed snapshot digest, empty if none */
+	std::vector<unsigned char> getSnapshotDigest() const;
 
 	/* Serialize method */
 	std::unique_ptr<unsigned char[]> serialize() const;
-	Block* deserialize(const std::unique_ptr<unsigned char[]>& buffer) const;
+	static Block* deserialize(const std::unique_ptr<unsigned char[]>& buffer);
+	/* In place decode of a block inside a larger frame, size bounds every read; nullptr if malformed */
+	static Block* deserialize(const unsigned char* buffer, size_t size);
+
+	/* Staged decode, the same checks as deserialize split so a pipeline can overlap blocks:
+	   the envelope is the bounds checked head plus a view of each transaction's bytes (valid
+	   while the buffer is), seal builds the block & checks it against the envelope */
+	struct Envelope
+	{
+		unsigned long long timestamp = 0;
+		float versionNum = 0;
+		unsigned int blockHeight = 0;
+		size_t blockSize = 0;
+		std::vector<unsigned char> prevHash, merkleRoot, currHash, snapshotDigest;
+		std::vector<std::span<const uint8_t>> txs;
+	};
+	static bool decodeEnvelope(const unsigned char* buffer, size_t size, Envelope& env);
+	static Block* seal(Envelope& env, const std::vector<transactions>& data, std::vector<unsigned char> merkleRoot);
 
-	/* Getters and Setters for Hashes */
+	/* Getters and Setters for Hashes, the hash covers the head only (the Merkle root commits to data) */
 	std::vector<unsigned char> setCurrHash() const;
+
+	/* Head hash from its fields alone, lets headers be checked before their body arrives */
+	static std::vector<unsigned char> headHash(unsigned long long ts, const std::vector<unsigned char>& prevHash, float versionNum,
+		const std::vector<unsigned char>& merkleRoot, unsigned int blockHeight, size_t blockSize,
+		const std::vector<unsigned char>& snapshotDigest);
 	std::vector<unsigned char> getCurrHash() const;
 	std::vector<unsigned char> getPrevHash() const;
 
@@ -94,6 +141,10 @@ public:
 	std::vector<transactions> getTxs() const;
 	std::vector<transactions> getData() const;
 
+	/* Drops the body, the head (hashes, Merkle root, height & size) stays */
+	void prune();
+	bool isPruned() const;
+
 	/* Size Calculations
 	*	Precedes Current Hash & Next.
 	*	Negates Utility for simplicity
@@ -25,6 +25,12 @@ BlockChain::~BlockChain() {
 		temp = temp->next;
 		delete save;
 	}
+	for (auto& [id, b] : sideBlocks) {
+		delete b;
+	}
+	for (Block* b : orphanOrder) {
+		delete b;
+	}
 	util::logCall("BLOCKCHAIN", "~BlockChain()", true);
 }
 
@@ -33,15 +39,15 @@ void BlockChain::initial(Block* initial) {
 		//Genesis Block Creation */
 		//Empty Transaction Data
 		std::vector<transactions> txs;
-		std::vector<std::string> tra;
+		std::vector<Address> tra;
 		std::vector<EVP_PKEY_ptr> trpk;
-		tra.emplace_back("NA");
-		std::vector<double> tamm;
-		tamm.push_back(1.0);
+		tra.emplace_back(); // null address, genesis has no recipient
+		std::vector<Amount> tamm;
+		tamm.push_back(Amounts::COIN_UNITS);
 		std::vector<std::string> del;
 		std::vector<std::string> delID;
-		std::vector<std::tuple<std::string, std::string, float>> votes;
-		transactions tx("NA", tra, tamm, 0.0, 7, 1.0, del, delID, votes);
+		std::vector<std::tuple<Address, std::string, float>> votes;
+		transactions tx(Address{}, tra, tamm, 0, 7, 1.0, del, delID, votes);
 		txs.push_back(tx);
 		//Data To be Hashed */
 		std::string dataToHash = "Genesis1:1; Thank you Jesus; Thank You God; A New creation => Your Creation";
@@ -51,6 +57,8 @@ void BlockChain::initial(Block* initial) {
 			first = Genesis;
 			currBlock = Genesis;
 			Genesis->next = nullptr;
+			indexTxs(Genesis);
+			linkBalances(Genesis);
 			util::logCall("BLOCKCHAIN", "initial()", true);
 		}
 		else {
@@ -62,6 +70,8 @@ void BlockChain::initial(Block* initial) {
 		first = initial;
 		currBlock = initial;
 		initial->next = nullptr;
+		indexTxs(initial);
+		linkBalances(initial);
 		util::logCall("BLOCKCHAIN", "initial()", true);
 	}
 }
@@ -72,12 +82,7 @@ void BlockChain::GenerateBlock(const std::vector<transactions>& d, Block* b) {
 		Block* newBlk = new Block(d,preBlk->getCurrHash(), getVersion(), (height + 1), util::TimeStamp());
 
 		/* Verify Block & update chain */
-		if (verifyBlock(newBlk)) {
-			preBlk->next = newBlk;
-			currBlock = newBlk;
-			currBlock->next = nullptr;
-			setHeight();
-			updateChnSlot();
+		if (connectBlock(newBlk)) {
 			util::logCall("BLOCKCHAIN", "GenerateBlock()", true);
 		}
 		else {
@@ -86,20 +91,281 @@ void BlockChain::GenerateBlock(const std::vector<transactions>& d, Block* b) {
 		}
 	}
 	else {
-		Block* preBlk = currBlock;
-
 		/* Verify Block & update chain */
-		if (verifyBlock(b)) {
-			preBlk->next = b;
-			currBlock = b;
-			currBlock->next = nullptr;
-			setHeight();
-			updateChnSlot();
-		}
+		connectBlock(b);
 		util::logCall("BLOCKCHAIN", "GenerateBlock()", true);
 	}
 }
 
+bool BlockChain::connectBlock(Block* b) {
+	if (!verifyBlock(b)) {
+		return false;
+	}
+	currBlock->next = b;
+	currBlock = b;
+	currBlock->next = nullptr;
+	indexTxs(b);
+	setHeight();
+	linkBalances(b);
+	updateChnSlot();
+	return true;
+}
+
+void BlockChain::disconnectTip() {
+	Block* b = currBlock;
+	const unsigned int bh = b->getBlockHeight();
+	if (b == lastConfirmed) {
+		unconfirmLast();
+	}
+	if (b == pruneFrom) {
+		pruneFrom = blockAt(bh - 1);
+	}
+	const std::vector<transactions> txs = b->getData();
+	for (size_t i = 0; i < txs.size(); i++) {
+		const transactions& tx = txs[i];
+		if (const auto it = txIndex.find(tx.getTxid()); it != txIndex.end() && it->second == bh) {
+			txIndex.erase(it);
+		}
+
+		auto unpost = [&](const Address& a) {
+			const auto it = history.find(a);
+			if (it == history.end()) return;
+			while (!it->second.empty() && it->second.back().height == bh) {
+				it->second.pop_back();
+			}
+			if (it->second.empty()) history.erase(it);
+		};
+		unpost(tx.getSendAddr());
+		for (const Address& ra : tx.getRecieveAddr()) {
+			unpost(ra);
+		}
+
+		Amount debit = 0;
+		if (txDebit(tx, i, debit) && debit > 0) {
+			if (const auto it = unconfirmedDebits.find(tx.getSendAddr()); it != unconfirmedDebits.end()) {
+				it->second -= std::min(it->second, debit);
+				if (it->second == 0) unconfirmedDebits.erase(it);
+			}
+		}
+	}
+
+	heightIndex.resize(bh);
+	currBlock = blockAt(bh - 1);
+	currBlock->next = nullptr;
+	height--;
+}
+
+std::string BlockChain::hashKey(const std::vector<unsigned char>& hash) {
+	return util::toHex(hash.data(), hash.size());
+}
+
+bool BlockChain::onMainChain(const std::vector<unsigned char>& hash, const unsigned int bheight) {
+	const Block* b = blockAt(bheight);
+	return b != nullptr && b->getCurrHash() == hash;
+}
+
+unsigned int BlockChain::reorgFloor() const {
+	/* Confirmed blocks down to the oldest undo record can be reverted, unconfirmed ones always */
+	if (lastConfirmed == nullptr) {
+		return first->getBlockHeight();
+	}
+	unsigned int floor = lastConfirmed->getBlockHeight();
+	while (floor > first->getBlockHeight() && undoLog.contains(floor)) {
+		floor--;
+	}
+	return floor;
+}
+
+bool BlockChain::knowsBlock(const std::vector<unsigned char>& hash, const unsigned int bheight) {
+	return onMainChain(hash, bheight) || sideBlocks.contains(hashKey(hash));
+}
+
+size_t BlockChain::orphanCount() const {
+	return orphans.size();
+}
+
+size_t BlockChain::sideCount() const {
+	return sideBlocks.size();
+}
+
+bool BlockChain::submitBlock(Block* b, TipChange& change) {
+	if (b == nullptr || empty()) {
+		return false;
+	}
+	const std::vector<unsigned char> hash = b->getCurrHash();
+	if (b->getBlockHeight() <= reorgFloor()) {
+		util::logCall("BLOCKCHAIN", "submitBlock()", false, "Below Reorg Floor");
+		return false;
+	}
+	bool duplicate = knowsBlock(hash, b->getBlockHeight());
+	for (auto [it, end] = orphans.equal_range(hashKey(b->getPrevHash())); it != end && !duplicate; ++it) {
+		duplicate = it->second->getCurrHash() == hash;
+	}
+	if (duplicate) {
+		util::logCall("BLOCKCHAIN", "submitBlock()", false, "Duplicate Block");
+		return false;
+	}
+
+	bool orphaned = false;
+	if (!placeBlock(b, change, orphaned)) {
+		return false;
+	}
+
+	/* Orphans waiting on a placed block are placed in turn, which may free their own children */
+	std::vector<Block*> ready;
+	if (!orphaned) {
+		ready.push_back(b);
+	}
+	while (!ready.empty()) {
+		Block* parent = ready.back();
+		ready.pop_back();
+		const auto [lo, hi] = orphans.equal_range(hashKey(parent->getCurrHash()));
+		std::vector<Block*> children;
+		for (auto it = lo; it != hi; ++it) {
+			children.push_back(it->second);
+		}
+		orphans.erase(lo, hi);
+		for (Block* child : children) {
+			std::erase(orphanOrder, child);
+			bool again = false;
+			if (!placeBlock(child, change, again)) {
+				delete child;
+			}
+			else if (!again) {
+				ready.push_back(child);
+			}
+		}
+	}
+	util::logCall("BLOCKCHAIN", "submitBlock()", true);
+	return true;
+}
+
+bool BlockChain::placeBlock(Block* b, TipChange& change, bool& orphaned) {
+	orphaned = false;
+	const unsigned int bh = b->getBlockHeight();
+	const std::vector<unsigned char> prev = b->getPrevHash();
+
+	/* Extends the tip */
+	if (prev == currBlock->getCurrHash()) {
+		if (!connectBlock(b)) {
+			return false;
+		}
+		change.connected.push_back(b);
+		return true;
+	}
+
+	/* Parent unknown: held until it arrives */
+	const auto side = sideBlocks.find(hashKey(prev));
+	if (side == sideBlocks.end() && !onMainChain(prev, bh - 1)) {
+		addOrphan(b);
+		orphaned = true;
+		return true;
+	}
+	if (side != sideBlocks.end() && side->second->getBlockHeight() + 1 != bh) {
+		util::logCall("BLOCKCHAIN", "placeBlock()", false, "Invalid block height");
+		return false;
+	}
+	if (sideBlocks.size() >= MAX_SIDE_BLOCKS) {
+		util::logCall("BLOCKCHAIN", "placeBlock()", false, "Side Branches Full");
+		return false;
+	}
+	sideBlocks.emplace(hashKey(b->getCurrHash()), b);
+
+	/* Longest chain wins, on a tie the tip seen first stays */
+	if (bh > currBlock->getBlockHeight() && !reorgTo(b, change)) {
+		sideBlocks.erase(hashKey(b->getCurrHash()));
+		return false;
+	}
+	return true;
+}
+
+bool BlockChain::reorgTo(Block* branchTip, TipChange& change) {
+	/* Side blocks back to where the branch leaves the main chain */
+	std::vector<Block*> branch{branchTip};
+	for (auto it = sideBlocks.find(hashKey(branchTip->getPrevHash())); it != sideBlocks.end();
+		it = sideBlocks.find(hashKey(it->second->getPrevHash()))) {
+		branch.push_back(it->second);
+	}
+	std::reverse(branch.begin(), branch.end());
+
+	const unsigned int fork = branch.front()->getBlockHeight() - 1;
+	if (!onMainChain(branch.front()->getPrevHash(), fork) || fork < reorgFloor()) {
+		util::logCall("BLOCKCHAIN", "reorgTo()", false, "Fork Below Reorg Floor");
+		return false;
+	}
+
+	std::vector<Block*> old;
+	while (currBlock->getBlockHeight() > fork) {
+		old.push_back(currBlock);
+		disconnectTip();
+	}
+	size_t linked = 0;
+	while (linked < branch.size() && connectBlock(branch[linked])) {
+		linked++;
+	}
+
+	if (linked == branch.size()) {
+		for (Block* b : branch) {
+			sideBlocks.erase(hashKey(b->getCurrHash()));
+		}
+		for (Block* b : old) {
+			sideBlocks.emplace(hashKey(b->getCurrHash()), b);
+		}
+		change.disconnected.insert(change.disconnected.end(), old.begin(), old.end());
+		change.connected.insert(change.connected.end(), branch.begin(), branch.end());
+		util::logCall("BLOCKCHAIN", "reorgTo()", true, std::to_string(old.size()) + " Blocks Replaced");
+		return true;
+	}
+
+	/* A branch block does not verify: the old chain goes back, the branch from that block on is dropped */
+	while (currBlock->getBlockHeight() > fork) {
+		disconnectTip();
+	}
+	for (auto it = old.rbegin(); it != old.rend(); ++it) {
+		connectBlock(*it);
+	}
+	for (size_t i = linked; i + 1 < branch.size(); i++) {
+		sideBlocks.erase(hashKey(branch[i]->getCurrHash()));
+		delete branch[i];
+	}
+	util::logCall("BLOCKCHAIN", "reorgTo()", false, "Branch Block Invalid");
+	return false;
+}
+
+void BlockChain::addOrphan(Block* b) {
+	if (orphanOrder.size() >= MAX_ORPHANS) {
+		Block* oldest = orphanOrder.front();
+		orphanOrder.pop_front();
+		for (auto [it, end] = orphans.equal_range(hashKey(oldest->getPrevHash())); it != end; ++it) {
+			if (it->second == oldest) {
+				orphans.erase(it);
+				break;
+			}
+		}
+		delete oldest;
+	}
+	orphans.emplace(hashKey(b->getPrevHash()), b);
+	orphanOrder.push_back(b);
+}
+
+void BlockChain::dropStale() {
+	/* Branches at or below the reorg floor can never become the main chain */
+	const unsigned int floor = reorgFloor();
+	std::erase_if(sideBlocks, [floor](const auto& entry) {
+		if (entry.second->getBlockHeight() > floor) return false;
+		delete entry.second;
+		return true;
+	});
+	std::erase_if(orphans, [floor](const auto& entry) {
+		return entry.second->getBlockHeight() <= floor;
+	});
+	std::erase_if(orphanOrder, [floor](Block* b) {
+		if (b->getBlockHeight() > floor) return false;
+		delete b;
+		return true;
+	});
+}
+
 bool BlockChain::empty() {
 	if (first == nullptr) {
 		return true;
@@ -134,62 +400,251 @@ void BlockChain::setHeight() {
 	height++;
 }
 
-bool BlockChain::isNewTxid(const std::string txid) {
-	Block* ptr = first;
-	std::vector<transactions> pbTxs;
-	while (ptr->next != nullptr) {
-		pbTxs = ptr->getTxs();
-		for (auto& tx : pbTxs) {
-			if (tx.getTxid() == txid) {
-				util::logCall("BLOCKCHAIN", "isNewTxid()", true);
-				return false; // tx is in blockchain
+void BlockChain::indexTxs(Block* b) {
+	const unsigned int bh = b->getBlockHeight();
+	if (heightIndex.size() <= bh) {
+		heightIndex.resize(bh + 1, nullptr);
+	}
+	heightIndex[bh] = b;
+
+	const std::vector<transactions> txs = b->getData();
+	for (uint32_t i = 0; i < txs.size(); i++) {
+		const transactions& tx = txs[i];
+		txIndex.emplace(tx.getTxid(), bh);
+
+		/* One posting per address per tx, even if it pays itself */
+		const TxPosting posting{bh, i};
+		auto post = [&](const Address& a) {
+			if (a.isNull()) return;
+			std::vector<TxPosting>& list = history[a];
+			if (list.empty() || list.back().height != bh || list.back().index != i) {
+				list.push_back(posting);
 			}
+		};
+		post(tx.getSendAddr());
+		for (const Address& ra : tx.getRecieveAddr()) {
+			post(ra);
 		}
-		ptr = ptr->next;
 	}
-	if (!ptr->getTxs().empty()) {
-		pbTxs = ptr->getTxs();
-		for (auto& tx : pbTxs) {
-			if (tx.getTxid() == txid) {
-				util::logCall("BLOCKCHAIN", "isNewTxid()", true);
-				return false; // tx is in blockchain
+}
+
+Block* BlockChain::blockAt(const unsigned int bheight) {
+	return bheight < heightIndex.size() ? heightIndex[bheight] : nullptr;
+}
+
+bool BlockChain::txDebit(const transactions& tx, const size_t pos, Amount& out) {
+	if (pos == 0) {
+		out = 0; // coinbase mints its outputs
+		return true;
+	}
+	Amount total = 0;
+	if (!tx.totalAmm(total) || !Amounts::add(total, tx.getFee(), total)) {
+		return false;
+	}
+	out = total;
+	return true;
+}
+
+void BlockChain::linkBalances(Block* b) {
+	const std::vector<transactions> txs = b->getData();
+	for (size_t i = 0; i < txs.size(); i++) {
+		Amount debit = 0;
+		if (!txDebit(txs[i], i, debit)) {
+			util::logCall("BLOCKCHAIN", "linkBalances()", false, "Amount Out Of Range");
+			continue;
+		}
+		if (debit > 0) {
+			Amount& pending = unconfirmedDebits[txs[i].getSendAddr()];
+			if (!Amounts::add(pending, debit, pending)) {
+				pending = Amounts::MAX_MONEY;
 			}
 		}
-		ptr = nullptr;
-		util::logCall("BLOCKCHAIN", "isNewTxid()", true);
-		return true;
 	}
-	else {
-		ptr = nullptr;
-		util::logCall("BLOCKCHAIN", "isNewTxid()", true);
-		return true;
+	confirmBalances();
+}
+
+void BlockChain::confirmBalances() {
+	const unsigned int tip = currBlock->getBlockHeight();
+	if (tip < conf) {
+		return;
+	}
+	const unsigned int target = tip - conf;
+
+	Block* next = (lastConfirmed == nullptr) ? first : lastConfirmed->next;
+	while (next != nullptr && next->getBlockHeight() <= target) {
+		/* Prior balance of every address touched, recorded once per block */
+		ChainUndo undo;
+		std::unordered_set<Address, AddressHash> touched;
+		auto remember = [&](const Address& a) {
+			if (touched.insert(a).second) {
+				undo.priorBalances.emplace_back(a, verifyBalance(a));
+			}
+		};
+
+		const std::vector<transactions> txs = next->getData();
+		for (size_t i = 0; i < txs.size(); i++) {
+			const transactions& tx = txs[i];
+
+			/* Credit recipients */
+			const std::vector<Address>& ra = tx.getRecieveAddr();
+			const std::vector<Amount>& am = tx.getAmmount();
+			if (i == 0) {
+				Amount coinbase = 0;
+				if (!tx.totalAmm(coinbase) || !Amounts::add(minted, coinbase, minted)) {
+					util::logCall("BLOCKCHAIN", "confirmBalances()", false, "Minted Overflow");
+				}
+				undo.minted = coinbase;
+			}
+			for (size_t j = 0; j < ra.size() && j < am.size(); j++) {
+				if (ra[j].isNull()) continue;
+				remember(ra[j]);
+				Amount& bal = balances[ra[j]];
+				if (!Amounts::add(bal, am[j], bal)) {
+					util::logCall("BLOCKCHAIN", "confirmBalances()", false, "Balance Overflow");
+				}
+			}
+
+			/* Debit sender, moving the debit out of the unconfirmed set */
+			Amount debit = 0;
+			if (!txDebit(tx, i, debit) || debit == 0) continue;
+			const Address& sa = tx.getSendAddr();
+			remember(sa);
+			Amount& bal = balances[sa];
+			if (!Amounts::sub(bal, debit, bal)) {
+				util::logCall("BLOCKCHAIN", "confirmBalances()", false, "Balance Underflow");
+				bal = 0;
+			}
+			if (const auto it = unconfirmedDebits.find(sa); it != unconfirmedDebits.end()) {
+				it->second -= std::min(it->second, debit);
+				if (it->second == 0) unconfirmedDebits.erase(it);
+			}
+		}
+		lastConfirmed = next;
+		undoLog[next->getBlockHeight()] = std::move(undo);
+		while (undoLog.begin()->first + UNDO_DEPTH <= next->getBlockHeight()) {
+			undoLog.erase(undoLog.begin());
+		}
+		next = next->next;
+	}
+}
+
+void BlockChain::unconfirmLast() {
+	Block* b = lastConfirmed;
+	const unsigned int bh = b->getBlockHeight();
+	const auto it = undoLog.find(bh);
+	if (it == undoLog.end()) {
+		util::logCall("BLOCKCHAIN", "unconfirmLast()", false, "No Undo Record");
+		return;
 	}
+
+	for (const auto& [addr, prior] : it->second.priorBalances) {
+		if (prior == 0) {
+			balances.erase(addr);
+		}
+		else {
+			balances[addr] = prior;
+		}
+	}
+	minted -= it->second.minted;
+	undoLog.erase(it);
+
+	/* Its debits are pending again, disconnectTip takes them out with the block */
+	const std::vector<transactions> txs = b->getData();
+	for (size_t i = 0; i < txs.size(); i++) {
+		Amount debit = 0;
+		if (txDebit(txs[i], i, debit) && debit > 0) {
+			Amount& pending = unconfirmedDebits[txs[i].getSendAddr()];
+			if (!Amounts::add(pending, debit, pending)) {
+				pending = Amounts::MAX_MONEY;
+			}
+		}
+	}
+	lastConfirmed = (b == first) ? nullptr : blockAt(bh - 1);
+}
+
+void BlockChain::pruneBodies(const Block* applied) {
+	if (pruneDepth == 0 || lastConfirmed == nullptr || applied == nullptr) {
+		return;
+	}
+	const unsigned int tip = currBlock->getBlockHeight();
+	const unsigned int keep = std::max<unsigned int>(pruneDepth, conf);
+	if (tip <= keep) {
+		return;
+	}
+
+	/* Never past the last confirmed block nor the caller's, their effects must be applied first */
+	const unsigned int limit = std::min({tip - keep, lastConfirmed->getBlockHeight(), applied->getBlockHeight()});
+	Block* b = (pruneFrom == nullptr) ? first : pruneFrom;
+	size_t dropped = 0;
+	while (b != nullptr && b->getBlockHeight() < limit) {
+		if (!b->isPruned()) {
+			b->prune();
+			undoLog.erase(b->getBlockHeight()); // no body, no disconnecting
+			dropped++;
+		}
+		b = b->next;
+	}
+	pruneFrom = b;
+	if (dropped > 0) {
+		util::logCall("BLOCKCHAIN", "pruneBodies()", true, std::to_string(dropped) + " Bodies Dropped");
+	}
+}
+
+bool BlockChain::setPruneDepth(const unsigned int keep) {
+	if (keep != 0 && keep < conf) {
+		util::logCall("BLOCKCHAIN", "setPruneDepth()", false, "Depth Below Confirmation Period");
+		return false;
+	}
+	pruneDepth = keep;
+	util::logCall("BLOCKCHAIN", "setPruneDepth()", true);
+	return true;
+}
+
+unsigned int BlockChain::getPruneDepth() const {
+	return pruneDepth;
+}
+
+Amount BlockChain::verifyBalance(const Address& wa) {
+	const auto it = balances.find(wa);
+	return it == balances.end() ? 0 : it->second;
+}
+
+Amount BlockChain::spendableBalance(const Address& wa) {
+	const Amount bal = verifyBalance(wa);
+	const auto it = unconfirmedDebits.find(wa);
+	const Amount pending = it == unconfirmedDebits.end() ? 0 : it->second;
+	return bal > pending ? bal - pending : 0;
+}
+
+bool BlockChain::isNewTxid(const std::string txid) {
+	util::logCall("BLOCKCHAIN", "isNewTxid()", true);
+	return !txIndex.contains(txid);
 }
 
 transactions BlockChain::getTx(const std::string txid) {
-	Block* ptr = first;
-	std::vector<transactions> pbTxs;
-	while (ptr->next != nullptr) {
-		pbTxs = ptr->getTxs();
-		for (auto& tx : pbTxs) {
-			if (tx.getTxid() == txid) {
-				util::logCall("BLOCKCHAIN", "getTx()", true);
-				return tx; // return tx
+	const auto it = txIndex.find(txid);
+	if (it != txIndex.end()) {
+		/* Only the holding block is searched */
+		Block* ptr = blockAt(it->second);
+		if (ptr != nullptr) {
+			for (auto& tx : ptr->getData()) {
+				if (tx.getTxid() == txid) {
+					util::logCall("BLOCKCHAIN", "getTx()", true);
+					return tx; // return tx
+				}
 			}
 		}
-		ptr = ptr->next;
 	}
-	ptr = nullptr;
 
 	/* Return Dummy Tx */
 	std::vector<transactions> txs;
-	std::vector<std::string> tra;
+	std::vector<Address> tra;
 	std::vector<EVP_PKEY_ptr> trpk;
-	std::vector<double> tamm;
+	std::vector<Amount> tamm;
 	std::vector<std::string> del;
 	std::vector<std::string> delID;
-	std::vector<std::tuple<std::string, std::string, float>> votes;
-	transactions dummy("", tra, tamm, 0.0, 0.0, 0.0, del, delID, votes);
+	std::vector<std::tuple<Address, std::string, float>> votes;
+	transactions dummy(Address{}, tra, tamm, 0, 0, 0.0, del, delID, votes);
 	util::logCall("BLOCKCHAIN", "getTx()", true);
 	return dummy;
 }
@@ -276,15 +731,22 @@ void BlockChain::setConf(unsigned short confirm) {
 	conf = confirm;
 }
 
-std::vector<transactions> BlockChain::checkWallets(std::string wa) {
-	/* Only Check Current block for transactions */
-	std::vector<transactions> pbTxs = currBlock->getData();
+std::vector<transactions> BlockChain::checkWallets(const Address& wa) {
+	/* Only Check Current block for transactions, newest postings are at the back */
 	std::vector<transactions> txout;
-	for (int i = 0; i < pbTxs.size(); i++) {
-		std::vector<std::string> ra = pbTxs[i].getRecieveAddr();
-		for (int j = 0; j < ra.size(); j++) {
-			if (ra[j] == wa) {
-				txout.push_back(pbTxs[i]); // wa is in blockchain
+	const auto it = history.find(wa);
+	if (it != history.end()) {
+		const unsigned int tip = currBlock->getBlockHeight();
+		const std::vector<TxPosting>& list = it->second;
+		size_t from = list.size();
+		while (from > 0 && list[from - 1].height == tip) {
+			from--;
+		}
+		const std::vector<transactions> pbTxs = currBlock->getData();
+		for (size_t p = from; p < list.size(); p++) {
+			const std::vector<Address>& ra = pbTxs[list[p].index].getRecieveAddr();
+			if (std::ranges::find(ra, wa) != ra.end()) {
+				txout.push_back(pbTxs[list[p].index]); // wa is in blockchain
 			}
 		}
 	}
@@ -292,6 +754,43 @@ std::vector<transactions> BlockChain::checkWallets(std::string wa) {
 	return txout;
 }
 
+std::vector<TxPosting> BlockChain::getHistory(const Address& wa, const size_t page, const size_t pageSize) {
+	std::vector<TxPosting> out;
+	const auto it = history.find(wa);
+	if (it == history.end() || pageSize == 0) {
+		return out;
+	}
+
+	const std::vector<TxPosting>& list = it->second;
+	const size_t skip = page * pageSize;
+	if (skip >= list.size()) {
+		return out;
+	}
+	const size_t end = list.size() - skip;
+	const size_t begin = end > pageSize ? end - pageSize : 0;
+	out.reserve(end - begin);
+	for (size_t i = end; i-- > begin;) {
+		out.push_back(list[i]);
+	}
+	return out;
+}
+
+std::vector<transactions> BlockChain::getHistoryTxs(const Address& wa, const size_t page, const size_t pageSize) {
+	std::vector<transactions> out;
+	for (const TxPosting& p : getHistory(wa, page, pageSize)) {
+		if (Block* b = blockAt(p.height); b != nullptr && !b->isPruned()) {
+			out.push_back(b->getData()[p.index]);
+		}
+	}
+	util::logCall("BLOCKCHAIN", "getHistoryTxs()", true);
+	return out;
+}
+
+size_t BlockChain::getHistorySize(const Address& wa) {
+	const auto it = history.find(wa);
+	return it == history.end() ? 0 : it->second.size();
+}
+
 void BlockChain::getBlock(unsigned int bheight) {
 	if (bheight <= height) {
 		Block* ptr = first;
@@ -349,50 +848,118 @@ void BlockChain::display() {
 }
 
 std::unique_ptr<unsigned char[]> BlockChain::serializeInfo() {
-	size_t tSize = 0;
-
-	/* tSize, timestamp, conf & version */
-	tSize += sizeof(size_t) + sizeof(unsigned long long) + sizeof(unsigned short) + sizeof(float);
-
-	/* Serialize Buffer */
-	std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-	size_t offset = 0;
-
-	std::memcpy(buffer.get() + offset, &tSize, sizeof(size_t)); //tSize
-	offset += sizeof(size_t);
-
-	std::memcpy(buffer.get() + offset, &timestamp, sizeof(unsigned long long)); //timestamp
-	offset += sizeof(unsigned long long);
+	return InfoWire::encode(*this);
+}
 
-	std::memcpy(buffer.get() + offset, &conf, sizeof(unsigned short)); //conf
-	offset += sizeof(unsigned short);
 
-	std::memcpy(buffer.get() + offset, &version, sizeof(float)); //version
+bool BlockChain::deserializeInfo(const std::unique_ptr<unsigned char[]>& info) {
+	InfoWire::Decoded d;
+	if (!InfoWire::decode(info, d)) {
+		util::logCall("BLOCKCHAIN", "deserializeInfo()", false, "Malformed Info");
+		return false;
+	}
 
-	return buffer;
+	/* Set Blockchain State */
+	setChnTmstmp(InfoWire::at<&BlockChain::timestamp>(d));
+	setConf(InfoWire::at<&BlockChain::conf>(d));
+	setVersion(InfoWire::at<&BlockChain::version>(d));
+	return true;
+}
+Block* BlockChain::getLastConfirmed() {
+	return lastConfirmed;
 }
 
+bool BlockChain::exportState(Snapshot& snap, const unsigned int h) {
+	if (lastConfirmed == nullptr || h > lastConfirmed->getBlockHeight()) {
+		util::logCall("BLOCKCHAIN", "exportState()", false, "Height Not Confirmed");
+		return false;
+	}
+	const Block* at = blockAt(h);
+	if (at == nullptr) {
+		util::logCall("BLOCKCHAIN", "exportState()", false, "Height Not Held");
+		return false;
+	}
 
-void BlockChain::deserializeInfo(const std::unique_ptr<unsigned char[]>& info) {
-	size_t tSize = 0;
-	size_t offset = 0;
-
-	std::memcpy(&tSize, info.get() + offset, sizeof(size_t));
-	offset += sizeof(size_t);
-
-	unsigned long long timestamp;
-	std::memcpy(&timestamp, info.get() + offset, sizeof(unsigned long long));
-	offset += sizeof(unsigned long long);
+	/* Newest first, so an address touched by several blocks ends at its balance before h + 1 */
+	std::unordered_map<Address, Amount, AddressHash> state = balances;
+	Amount mintedAt = minted;
+	for (unsigned int bh = lastConfirmed->getBlockHeight(); bh > h; bh--) {
+		const auto it = undoLog.find(bh);
+		if (it == undoLog.end()) {
+			util::logCall("BLOCKCHAIN", "exportState()", false, "No Undo Record");
+			return false;
+		}
+		for (const auto& [addr, prior] : it->second.priorBalances) {
+			if (prior == 0) {
+				state.erase(addr);
+			}
+			else {
+				state[addr] = prior;
+			}
+		}
+		mintedAt -= it->second.minted;
+	}
 
-	unsigned short conf;
-	std::memcpy(&conf, info.get() + offset, sizeof(unsigned short));
-	offset += sizeof(unsigned short);
+	snap.height = h;
+	snap.anchor = at->getCurrHash();
+	snap.chainVersion = version;
+	snap.conf = conf;
+	snap.minted = mintedAt;
+
+	/* Sorted, so every node encodes the same state to the same bytes */
+	snap.balances.clear();
+	snap.balances.reserve(state.size());
+	for (const auto& [addr, bal] : state) {
+		if (bal > 0) {
+			snap.balances.emplace_back(addr, bal);
+		}
+	}
+	std::sort(snap.balances.begin(), snap.balances.end(),
+		[](const auto& a, const auto& b) { return a.first < b.first; });
+
+	snap.txids.clear();
+	snap.txids.reserve(txIndex.size());
+	for (const auto& [id, th] : txIndex) {
+		if (th <= h) {
+			snap.txids.emplace_back(id, th);
+		}
+	}
+	std::ranges::sort(snap.txids);
+	util::logCall("BLOCKCHAIN", "exportState()", true);
+	return true;
+}
 
-	float version;
-	std::memcpy(&version, info.get() + offset, sizeof(float));
+bool BlockChain::importState(const Snapshot& snap, Block* anchor) {
+	if (!empty() || anchor == nullptr || anchor->getBlockHeight() != snap.height
+		|| anchor->getCurrHash() != snap.anchor) {
+		util::logCall("BLOCKCHAIN", "importState()", false, "Anchor Mismatch");
+		return false;
+	}
 
-	/* Set Blockchain State */
-	setChnTmstmp(timestamp);
-	setConf(conf);
-	setVersion(version);
-}
\ No newline at end of file
+	/* The anchor is the first block held, everything below it is known through the snapshot only */
+	first = anchor;
+	currBlock = anchor;
+	lastConfirmed = anchor;
+	pruneFrom = anchor;
+	anchor->next = nullptr;
+	height = snap.height;
+	version = snap.chainVersion;
+	conf = snap.conf;
+	minted = snap.minted;
+
+	txIndex.clear();
+	txIndex.reserve(snap.txids.size());
+	for (const auto& [id, th] : snap.txids) {
+		txIndex.emplace(id, th);
+	}
+	balances.clear();
+	balances.reserve(snap.balances.size());
+	for (const auto& [addr, bal] : snap.balances) {
+		balances.emplace(addr, bal);
+	}
+	unconfirmedDebits.clear();
+	undoLog.clear();
+	indexTxs(anchor);
+	util::logCall("BLOCKCHAIN", "importState()", true);
+	return true;
+}
@@ -2,7 +2,21 @@
 #define BLOCKCHAIN
 #include "Block.h"
 #include "CryptoTypes.h"
+#include "Address.h"
+#include "Snapshot.h"
+#include "Undo.h"
+#include <map>
 #include <iostream>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+/* Position of a transaction in the chain */
+struct TxPosting { unsigned int height = 0; uint32_t index = 0; };
+
+/* Main chain blocks a submitBlock took off (newest first, confirmed ones already reverted) & put on (in height order) */
+struct TipChange { std::vector<Block*> disconnected; std::vector<Block*> connected; };
+
 /*-- BlockChain.h ---------------------------------------------------------------
   This header file defines the Blockchain Logic that will be the Base for This
   Project
@@ -29,6 +43,23 @@ public:
 	/* Creates a Block into the chain*/
 	void GenerateBlock(const std::vector<transactions>& d, Block* b = nullptr);
 
+	/* Block tree: a received block is placed wherever it links. It extends the tip, joins a side
+	   branch (the chain reorgs onto a branch once it is longer than the tip) or waits in the orphan
+	   pool until its parent arrives. false: rejected & still owned by the caller.
+	   Blocks in change stay alive until dropStale, which the caller runs once it has applied them */
+	bool submitBlock(Block* b, TipChange& change);
+
+	/* Frees side branches & orphans at or below the reorg floor, they can never become the main chain */
+	void dropStale();
+
+	/* Confirmed blocks keeping an undo record, how deep a reorg can reach below the confirmed height */
+	static constexpr unsigned int UNDO_DEPTH = 100;
+
+	/* Block known on the main chain or a side branch */
+	bool knowsBlock(const std::vector<unsigned char>& hash, unsigned int bheight);
+	size_t orphanCount() const;
+	size_t sideCount() const;
+
 	/* Checks to see if Blockchain is Empty */
 	bool empty();
 
@@ -41,8 +72,11 @@ public:
 	/* Set Height of the Blockchain */
 	void setHeight();
 
-	/* Verifies the balance of a wallet address */
-	double verifyBalance(std::string wa);
+	/* Confirmed balance of any address, 0 if it was never paid */
+	Amount verifyBalance(const Address& wa);
+
+	/* Confirmed balance less what the address spent in blocks not yet confirmed */
+	Amount spendableBalance(const Address& wa);
 
 	/* Verifies the tx-id is not already present in the chain */
 	bool isNewTxid(std::string txid);
@@ -87,11 +121,19 @@ public:
 	void updateChnSlot();
 
 	/* Check Method for if wallets in new block */
-	std::vector<transactions> checkWallets(std::string wa);
+	std::vector<transactions> checkWallets(const Address& wa);
+
+	/* Paged history of an address, newest first, page 0 is the latest */
+	std::vector<TxPosting> getHistory(const Address& wa, size_t page, size_t pageSize);
+	std::vector<transactions> getHistoryTxs(const Address& wa, size_t page, size_t pageSize);
+	size_t getHistorySize(const Address& wa);
 
 	/* Display block in Blockchain at any height */
 	void getBlock(unsigned int bheight);
 
+	/* Block at height, nullptr if not in the chain */
+	Block* blockAt(unsigned int bheight);
+
 	/* Returns latest confirmed block! */
 	Block* confirmation();
 
@@ -101,8 +143,27 @@ public:
 	/* Serialize Current Blockchain State */
 	std::unique_ptr<unsigned char[]> serializeInfo();
 
-	/* Deserialize Current Blockchain State */
-	void deserializeInfo(const std::unique_ptr<unsigned char[]>& info);
+	/* Deserialize Current Blockchain State, false (nothing set) if malformed */
+	bool deserializeInfo(const std::unique_ptr<unsigned char[]>& info);
+
+	/* Last block applied to the balance index, nullptr before the first confirmation */
+	Block* getLastConfirmed();
+
+	/* Chain derived state as of confirmed height h, heights above it are rolled back through
+	   their undo records; false if h is not confirmed or older than UNDO_DEPTH */
+	bool exportState(Snapshot& snap, unsigned int h);
+
+	/* Starts an empty chain at a snapshot's anchor block instead of genesis */
+	bool importState(const Snapshot& snap, Block* anchor);
+
+	/* Pruned mode: keep the bodies of the tip & the keep blocks below it, headers of all.
+	   0 = archival (every body), otherwise keep must be at least conf */
+	bool setPruneDepth(unsigned int keep);
+	unsigned int getPruneDepth() const;
+
+	/* Drops bodies that fell below the prune depth, never past applied: the last block whose txs
+	   the caller has taken into its own state (wallet, consensus), their effects are in the indexes already */
+	void pruneBodies(const Block* applied);
 
 
 private:
@@ -114,6 +175,70 @@ private:
 	static util utility;
 	unsigned int height;
 	float version;
+
+	/* Info wire layout: tSize | timestamp | conf | version */
+	using InfoWire = serial::Layout<BlockChain, serial::Field<&BlockChain::timestamp>, serial::Field<&BlockChain::conf>,
+		serial::Field<&BlockChain::version>>;
+
+	/* txid -> height of the block holding it, txids are content addresses */
+	std::unordered_map<std::string, unsigned int> txIndex;
+
+	/* Blocks by height, heights are contiguous from the first block */
+	std::vector<Block*> heightIndex;
+
+	/* address -> (height, tx index) of every tx it sent or received, in chain order */
+	std::unordered_map<Address, std::vector<TxPosting>, AddressHash> history;
+
+	/* Adds a newly linked block to txIndex, heightIndex & history */
+	void indexTxs(Block* b);
+
+	/* Address balance index: credits & debits of blocks at conf depth */
+	std::unordered_map<Address, Amount, AddressHash> balances;
+	/* Debits of linked blocks not yet at conf depth */
+	std::unordered_map<Address, Amount, AddressHash> unconfirmedDebits;
+	/* Last block applied to balances */
+	Block* lastConfirmed = nullptr;
+	/* Coinbase outputs of confirmed blocks */
+	Amount minted = 0;
+
+	/* Bodies kept below the tip, 0 = archival; first block still holding its body */
+	unsigned int pruneDepth = 0;
+	Block* pruneFrom = nullptr;
+
+	/* Block tree: side branches by hash & orphans by the parent they wait for (hex keys), both owned
+	   by the chain. Forks are followed down to reorgFloor(), confirmed blocks above it are reverted
+	   with their undo records */
+	static constexpr size_t MAX_ORPHANS = 64;
+	static constexpr size_t MAX_SIDE_BLOCKS = 256;
+	std::unordered_map<std::string, Block*> sideBlocks;
+	std::unordered_multimap<std::string, Block*> orphans;
+	std::deque<Block*> orphanOrder; // oldest first, evicted once the pool is full
+
+	static std::string hashKey(const std::vector<unsigned char>& hash);
+	bool onMainChain(const std::vector<unsigned char>& hash, unsigned int bheight);
+	unsigned int reorgFloor() const;
+
+	/* Undo records of the last UNDO_DEPTH confirmed blocks, by height */
+	std::map<unsigned int, ChainUndo> undoLog;
+
+	/* Reverts the balance effects of lastConfirmed, its block becomes unconfirmed again */
+	void unconfirmLast();
+
+	/* Links b on the tip / unlinks the tip (unconfirming it first if needed), keeping every index in step */
+	bool connectBlock(Block* b);
+	void disconnectTip();
+
+	/* Places one block; orphaned is set if it went to the orphan pool */
+	bool placeBlock(Block* b, TipChange& change, bool& orphaned);
+	bool reorgTo(Block* branchTip, TipChange& change);
+	void addOrphan(Block* b);
+
+	/* Records the debits of a newly linked block, then confirms what reached conf depth */
+	void linkBalances(Block* b);
+	void confirmBalances();
+
+	/* Amount leaving the sender: outputs + fee, 0 for the coinbase (first tx of a block) */
+	static bool txDebit(const transactions& tx, size_t pos, Amount& out);
 };
 
 #endif
\ No newline at end of file
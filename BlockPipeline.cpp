@@ -0,0 +1,194 @@
+#include "BlockPipeline.h"
+
+BlockPipeline::BlockPipeline(Sink s, size_t n) : sink(std::move(s)) {
+    if (n == 0) {
+        n = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < n; i++) {
+        workers.emplace_back(&BlockPipeline::workLoop, this);
+    }
+    applier = std::thread(&BlockPipeline::applyLoop, this);
+}
+
+BlockPipeline::~BlockPipeline() {
+    stop();
+}
+
+void BlockPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    cvTask.notify_all();
+    cvApply.notify_all();
+    cvSpace.notify_all();
+
+    for (auto& t : workers) {
+        t.join();
+    }
+    applier.join();
+
+    /* Blocks sealed but never applied are still owned here */
+    for (const auto& job : order) {
+        delete job->block;
+    }
+    order.clear();
+    tasks.clear();
+}
+
+void BlockPipeline::submit(const unsigned char* buffer, const size_t size) {
+    auto job = std::make_shared<Job>();
+    job->raw.reset(new unsigned char[size]);
+    std::memcpy(job->raw.get(), buffer, size);
+    job->size = size;
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cvSpace.wait(lock, [this] { return stopping || order.size() < MAX_IN_FLIGHT; });
+        if (stopping) {
+            return;
+        }
+        order.push_back(job);
+    }
+    post([this, job] { decode(job); });
+}
+
+void BlockPipeline::drain() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cvSpace.wait(lock, [this] { return stopping || (order.empty() && applying == 0); });
+}
+
+size_t BlockPipeline::inFlight() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return order.size() + applying;
+}
+
+bool BlockPipeline::structureValid(const Block::Envelope& env) {
+    /* Every block carries its coinbase & a hash chain link */
+    return !env.txs.empty() && env.timestamp != 0 && !env.currHash.empty() && !env.merkleRoot.empty()
+        && (env.blockHeight == 0 || !env.prevHash.empty());
+}
+
+void BlockPipeline::decode(const std::shared_ptr<Job>& job) {
+    if (!Block::decodeEnvelope(job->raw.get(), job->size, job->env) || !structureValid(job->env)) {
+        util::logCall("BLOCKPIPELINE", "decode()", false, "Malformed Block");
+        finish(job, nullptr);
+        return;
+    }
+
+    const size_t n = job->env.txs.size();
+    const size_t chunks = (n + TX_CHUNK - 1) / TX_CHUNK;
+    job->txs.resize(n);
+    job->chunksLeft = chunks;
+
+    /* This worker keeps the first chunk, the rest go to whoever is free */
+    for (size_t c = 1; c < chunks; c++) {
+        const size_t from = c * TX_CHUNK;
+        post([this, job, from, n] { checkTxs(job, from, std::min(from + TX_CHUNK, n)); });
+    }
+    checkTxs(job, 0, std::min(TX_CHUNK, n));
+}
+
+void BlockPipeline::checkTxs(const std::shared_ptr<Job>& job, const size_t from, const size_t to) {
+    for (size_t i = from; i < to && !job->failed; i++) {
+        if (!transactions::decode(job->env.txs[i], job->txs[i])) {
+            job->failed = true;
+            break;
+        }
+
+        /* The coinbase pays whatever reward is left, possibly nothing, so only its shape is checked */
+        const transactions& t = *job->txs[i];
+        const bool ok = i == 0 ? !t.getRecieveAddr().empty() : t.inputsValid() && t.outputsValid();
+        if (!ok) {
+            util::logCall("BLOCKPIPELINE", "checkTxs()", false, "Transaction Invalid");
+            job->failed = true;
+        }
+    }
+
+    /* The last chunk to finish seals the block */
+    if (--job->chunksLeft == 0) {
+        seal(job);
+    }
+}
+
+void BlockPipeline::seal(const std::shared_ptr<Job>& job) {
+    if (job->failed) {
+        finish(job, nullptr);
+        return;
+    }
+
+    std::vector<transactions> data;
+    data.reserve(job->txs.size());
+    for (const auto& tx : job->txs) {
+        data.push_back(*tx);
+    }
+    job->txs.clear();
+
+    std::vector<unsigned char> root = Block::MerkleRoot(data);
+    finish(job, Block::seal(job->env, data, std::move(root)));
+}
+
+void BlockPipeline::finish(const std::shared_ptr<Job>& job, Block* block) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job->block = block;
+        job->done = true;
+        job->raw.reset(); // the envelope's views die with it
+        job->env.txs.clear();
+    }
+    cvApply.notify_one();
+}
+
+void BlockPipeline::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+    cvTask.notify_one();
+}
+
+void BlockPipeline::workLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cvTask.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void BlockPipeline::applyLoop() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cvApply.wait(lock, [this] { return stopping || (!order.empty() && order.front()->done); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(order.front());
+            order.pop_front();
+            applying = 1;
+        }
+        cvSpace.notify_all();
+
+        if (job->block != nullptr) {
+            sink(job->block);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            applying = 0;
+        }
+        cvSpace.notify_all();
+    }
+}
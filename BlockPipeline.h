@@ -0,0 +1,100 @@
+#ifndef BLOCKPIPELINE
+#define BLOCKPIPELINE
+
+#include "util.h"
+#include "Block.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*-- BlockPipeline.h ----------------------------------------------------------
+
+  This header file defines the staged block validation pipeline used by
+  chain sync. A received block goes through:
+
+	 decode:      Envelope bounds checked, every transaction's bytes split
+	              out (Block::decodeEnvelope), structural checks
+	 tx checks:   Transactions decoded & hashed in chunks, each chunk on
+	              any free worker; every tx but the coinbase gets the
+	              checks the mempool admits txs with
+	 seal:        Merkle root & head hash checked (Block::seal)
+	 apply:       The sink, called with each valid block in submission
+	              order on one thread of its own
+
+  The first three stages run on a pool of workers, so while block n is
+  being sealed or applied the blocks after it are already being decoded
+  and checked. Throughput grows with cores until apply is the bottleneck.
+
+  Basic operations are:
+	 submit:   Copies a serialized block in, waits while MAX_IN_FLIGHT
+	           blocks are already queued
+	 drain:    Waits until every submitted block went through the sink
+	 stop:     Joins the workers & apply thread, what is queued is dropped
+
+Note:
+  Blocks failing any stage are logged & deleted, the sink only sees valid
+  ones. The sink is never called concurrently with itself but does run
+  off the submitting thread, whatever it touches must lock.
+-------------------------------------------------------------------------*/
+
+class BlockPipeline
+{
+public:
+	using Sink = std::function<void(Block*)>;
+
+	static constexpr size_t MAX_IN_FLIGHT = 256; // blocks between submit & the sink
+	static constexpr size_t TX_CHUNK = 64; // txs per worker task
+
+	/* workers = 0 uses one per core */
+	explicit BlockPipeline(Sink sink, size_t workers = 0);
+	~BlockPipeline();
+
+	BlockPipeline(const BlockPipeline&) = delete;
+	BlockPipeline& operator=(const BlockPipeline&) = delete;
+
+	void submit(const unsigned char* buffer, size_t size);
+	void drain();
+	void stop();
+	size_t inFlight();
+
+private:
+	struct Job
+	{
+		std::unique_ptr<unsigned char[]> raw;
+		size_t size = 0;
+		Block::Envelope env;
+		std::vector<std::optional<transactions>> txs; // one slot per tx, filled by its chunk
+		std::atomic<size_t> chunksLeft{0};
+		std::atomic<bool> failed{false};
+		Block* block = nullptr; // sealed result, nullptr if rejected
+		bool done = false;
+	};
+
+	/* Stages, each runs as a worker task */
+	void decode(const std::shared_ptr<Job>& job);
+	void checkTxs(const std::shared_ptr<Job>& job, size_t from, size_t to);
+	void seal(const std::shared_ptr<Job>& job);
+	void finish(const std::shared_ptr<Job>& job, Block* block);
+
+	static bool structureValid(const Block::Envelope& env);
+
+	void post(std::function<void()> task);
+	void workLoop();
+	void applyLoop();
+
+	Sink sink;
+	std::mutex mtx;
+	std::condition_variable cvTask; // a task was posted
+	std::condition_variable cvApply; // a job finished
+	std::condition_variable cvSpace; // the sink took a job
+	std::deque<std::function<void()>> tasks;
+	std::deque<std::shared_ptr<Job>> order; // submission order, apply pops the front once done
+	size_t applying = 0; // job handed to the sink, not yet returned
+	bool stopping = false;
+	std::vector<std::thread> workers;
+	std::thread applier;
+};
+
+#endif
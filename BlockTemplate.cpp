@@ -0,0 +1,114 @@
+/*-- BlockTemplate.cpp --------------------------------------------------------
+   This file implements the incremental block template member functions.
+-----------------------------------------------------------------------------*/
+#include "BlockTemplate.h"
+
+void BlockTemplate::reset(const size_t budget) {
+    std::lock_guard<std::mutex> lock(mtx);
+    selected.clear();
+    leaves.clear();
+    ids.clear();
+    body.clear();
+    used = 0;
+    limit = budget;
+    refused = false;
+}
+
+bool BlockTemplate::offer(const transactions& tx) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const size_t size = tx.getSize();
+    if (ids.contains(tx.getTxid())) {
+        return false;
+    }
+    if (used + size > limit) {
+        refused = true;
+        return false;
+    }
+
+    ids.insert(tx.getTxid());
+    leaves.push_back(MerkleBuilder::leaf(tx));
+    body.append(leaves.back());
+    selected.push_back(tx);
+    used += size;
+    return true;
+}
+
+void BlockTemplate::drop(const std::vector<std::string>& txids) {
+    std::lock_guard<std::mutex> lock(mtx);
+    size_t hits = 0;
+    for (const auto& id : txids) {
+        hits += ids.erase(id);
+    }
+    if (hits == 0) {
+        return;
+    }
+
+    /* Survivors keep their order, the tree is rebuilt over their leaves */
+    std::vector<transactions> kept;
+    std::vector<std::vector<unsigned char>> keptLeaves;
+    kept.reserve(selected.size() - hits);
+    keptLeaves.reserve(selected.size() - hits);
+    body.clear();
+    used = 0;
+    for (size_t i = 0; i < selected.size(); i++) {
+        if (!ids.contains(selected[i].getTxid())) {
+            continue;
+        }
+        used += selected[i].getSize();
+        body.append(leaves[i]);
+        kept.push_back(selected[i]);
+        keptLeaves.push_back(std::move(leaves[i]));
+    }
+    selected.swap(kept);
+    leaves.swap(keptLeaves);
+    util::logCall("BLOCKTEMPLATE", "drop()", true);
+}
+
+void BlockTemplate::fit(const size_t budget) {
+    if (used <= budget) {
+        return;
+    }
+
+    /* Rare: the coinbase outgrew its share, drop tail txs & rebuild the tree */
+    while (used > budget && !selected.empty()) {
+        used -= selected.back().getSize();
+        ids.erase(selected.back().getTxid());
+        selected.pop_back();
+        leaves.pop_back();
+    }
+    body.clear();
+    for (const auto& leaf : leaves) {
+        body.append(leaf);
+    }
+    util::logCall("BLOCKTEMPLATE", "fit()", true, "Template Trimmed For Coinbase");
+}
+
+void BlockTemplate::assemble(const transactions& coinbase, std::vector<transactions>& txs, std::vector<unsigned char>& merkleRoot) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const size_t cbSize = coinbase.getSize();
+    fit(limit > cbSize ? limit - cbSize : 0);
+
+    txs.clear();
+    txs.reserve(selected.size() + 1);
+    txs.push_back(coinbase);
+    for (const auto& tx : selected) {
+        txs.push_back(tx);
+    }
+    merkleRoot = MerkleBuilder::blockRoot(MerkleBuilder::leaf(coinbase), body.root());
+    util::logCall("BLOCKTEMPLATE", "assemble()", true);
+}
+
+size_t BlockTemplate::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return selected.size();
+}
+
+size_t BlockTemplate::bytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return used;
+}
+
+bool BlockTemplate::stale() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return refused;
+}
@@ -0,0 +1,65 @@
+#ifndef BLOCKTEMPLATE
+#define BLOCKTEMPLATE
+
+#include "util.h"
+#include "transactions.h"
+#include "Merkle.h"
+#include <mutex>
+#include <unordered_set>
+
+/*-- BlockTemplate.h ----------------------------------------------------------
+
+  This header file defines the next-block template a delegate keeps while
+  waiting for its slot. Transactions are added as they enter the mempool,
+  the running byte size is kept against the block size limit and the
+  Merkle tree of the template grows with every tx, so producing a block
+  at slot time only has to add the coinbase.
+
+  Basic operations are:
+	 reset:     Empties the template for a new tip with a byte budget
+	 offer:     Appends a tx if it is new and still fits, a tx refused
+	            for room marks the template stale
+	 drop:      Takes out txs that left the mempool, rebuilding the tree
+	            once per call
+	 assemble:  Coinbase + template txs & their Merkle root, dropping
+	            tail txs if the coinbase does not fit the budget
+
+Note:
+  The coinbase is only known at slot time (it carries the consensus
+  state), which is why the block root is H(coinbase leaf || body root),
+  see Merkle.h. All members lock the template, the message thread offers
+  while the block thread assembles. Offers arrive in mempool order, not
+  fee-rate order, so a full template may hold worse paying txs than one
+  it refused; the producer rebuilds a stale template from the mempool's
+  fee-rate selection before assembling.
+-------------------------------------------------------------------------*/
+
+class BlockTemplate
+{
+public:
+	void reset(size_t budget);
+	bool offer(const transactions& tx);
+	void drop(const std::vector<std::string>& txids);
+	void assemble(const transactions& coinbase, std::vector<transactions>& txs, std::vector<unsigned char>& merkleRoot);
+
+	size_t size() const;
+	size_t bytes() const;
+
+	/* A tx was refused for room since the last reset */
+	bool stale() const;
+
+private:
+	/* Callers hold mtx */
+	void fit(size_t budget);
+
+	mutable std::mutex mtx;
+	std::vector<transactions> selected;
+	std::vector<std::vector<unsigned char>> leaves;
+	std::unordered_set<std::string> ids;
+	MerkleBuilder body;
+	size_t used = 0;
+	size_t limit = 0;
+	bool refused = false;
+};
+
+#endif
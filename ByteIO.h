@@ -0,0 +1,104 @@
+#ifndef BYTEIO
+#define BYTEIO
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/*-- ByteIO.h -----------------------------------------------------------------
+
+  This header file defines the cursor & builder shared by the network
+  message encoders. Every buffer follows the repo convention: its first
+  size_t is the total size of the buffer, itself included.
+
+	 ByteWriter:  Appends fields, finish() prefixes the total size
+	 ByteReader:  Bounds checked reads, every read fails instead of
+	              running past the size the buffer claims
+-------------------------------------------------------------------------*/
+
+struct ByteReader
+{
+	const unsigned char* p = nullptr;
+	size_t left = 0;
+
+	/* Opens a size prefixed buffer, positioned after the size */
+	bool open(const std::unique_ptr<unsigned char[]>& buffer) {
+		if (!buffer) return false;
+		size_t tSize = 0;
+		std::memcpy(&tSize, buffer.get(), sizeof(size_t));
+		if (tSize < sizeof(size_t)) return false;
+		p = buffer.get() + sizeof(size_t);
+		left = tSize - sizeof(size_t);
+		return true;
+	}
+
+	bool read(void* out, const size_t n) {
+		if (n > left) return false;
+		if (n == 0) return true;
+		std::memcpy(out, p, n);
+		p += n; left -= n;
+		return true;
+	}
+
+	/* size_t length then bytes, length capped at max */
+	bool bytes(std::vector<unsigned char>& out, const size_t max) {
+		size_t n = 0;
+		if (!read(&n, sizeof(size_t)) || n > max || n > left) return false;
+		out.assign(p, p + n);
+		p += n; left -= n;
+		return true;
+	}
+
+	/* Next size prefixed sub-buffer left in place, valid while the source buffer lives */
+	bool view(const unsigned char*& start, size_t& n) {
+		if (left < sizeof(size_t)) return false;
+		std::memcpy(&n, p, sizeof(size_t));
+		if (n < sizeof(size_t) || n > left) return false;
+		start = p;
+		p += n; left -= n;
+		return true;
+	}
+
+	/* Next size prefixed sub-buffer (a serialized tx or block), copied out */
+	bool buffer(std::unique_ptr<unsigned char[]>& out, const size_t minSize = sizeof(size_t)) {
+		size_t n = 0;
+		if (left < sizeof(size_t)) return false;
+		std::memcpy(&n, p, sizeof(size_t));
+		if (n < minSize || n < sizeof(size_t) || n > left) return false;
+		out.reset(new unsigned char[n]);
+		return read(out.get(), n);
+	}
+};
+
+struct ByteWriter
+{
+	std::vector<unsigned char> body;
+
+	void put(const void* v, const size_t n) {
+		const auto* b = static_cast<const unsigned char*>(v);
+		body.insert(body.end(), b, b + n);
+	}
+
+	void bytes(const std::vector<unsigned char>& v) {
+		const size_t n = v.size();
+		put(&n, sizeof(size_t));
+		put(v.data(), n);
+	}
+
+	/* Appends a size prefixed sub-buffer as is */
+	void buffer(const std::unique_ptr<unsigned char[]>& b) {
+		size_t n = 0;
+		std::memcpy(&n, b.get(), sizeof(size_t));
+		put(b.get(), n);
+	}
+
+	std::unique_ptr<unsigned char[]> finish() const {
+		const size_t tSize = sizeof(size_t) + body.size();
+		std::unique_ptr<unsigned char[]> out(new unsigned char[tSize]);
+		std::memcpy(out.get(), &tSize, sizeof(size_t));
+		std::memcpy(out.get() + sizeof(size_t), body.data(), body.size());
+		return out;
+	}
+};
+
+#endif
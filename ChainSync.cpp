@@ -0,0 +1,278 @@
+/*-- ChainSync.cpp ------------------------------------------------------------
+   This file implements headers-first chain download.
+-----------------------------------------------------------------------------*/
+#include "ChainSync.h"
+#include "ByteIO.h"
+
+BlockHeader BlockHeader::of(const Block* b) {
+    BlockHeader h;
+    h.timestamp = b->getTimestamp();
+    h.version = b->getVersion();
+    h.height = b->getBlockHeight();
+    h.blockSize = b->getSize();
+    h.prevHash = b->getPrevHash();
+    h.merkleRoot = b->getMerkleRoot();
+    h.currHash = b->getCurrHash();
+    h.snapshotDigest = b->getSnapshotDigest();
+    return h;
+}
+
+bool BlockHeader::hashValid() const {
+    return !currHash.empty() && Block::headHash(timestamp, prevHash, version, merkleRoot, height, blockSize, snapshotDigest) == currHash;
+}
+
+bool BlockHeader::matches(const Block* b) const {
+    /* A body's hash commits to its Merkle root, so an equal hash means the body is the one headed */
+    return b->getBlockHeight() == height && b->getCurrHash() == currHash;
+}
+
+std::unique_ptr<unsigned char[]> BlockHeader::serializeList(const std::vector<BlockHeader>& list) {
+    ByteWriter w;
+    const size_t count = list.size();
+    w.put(&count, sizeof(size_t));
+    for (const auto& h : list) {
+        w.put(&h.timestamp, sizeof(h.timestamp));
+        w.put(&h.version, sizeof(h.version));
+        w.put(&h.height, sizeof(h.height));
+        w.put(&h.blockSize, sizeof(h.blockSize));
+        w.bytes(h.prevHash);
+        w.bytes(h.merkleRoot);
+        w.bytes(h.currHash);
+        w.bytes(h.snapshotDigest);
+    }
+    return w.finish();
+}
+
+bool BlockHeader::deserializeList(const std::unique_ptr<unsigned char[]>& buffer, std::vector<BlockHeader>& list) {
+    constexpr size_t maxHashSize = 256;
+    ByteReader r;
+    size_t count = 0;
+    list.clear();
+    if (!r.open(buffer) || !r.read(&count, sizeof(size_t)) || count > ChainSync::MAX_HEADERS) {
+        util::logCall("CHAINSYNC", "deserializeList()", false, "Malformed Headers");
+        return false;
+    }
+    list.resize(count);
+    for (auto& h : list) {
+        if (!r.read(&h.timestamp, sizeof(h.timestamp)) || !r.read(&h.version, sizeof(h.version))
+            || !r.read(&h.height, sizeof(h.height)) || !r.read(&h.blockSize, sizeof(h.blockSize))
+            || !r.bytes(h.prevHash, maxHashSize) || !r.bytes(h.merkleRoot, maxHashSize) || !r.bytes(h.currHash, maxHashSize)
+            || !r.bytes(h.snapshotDigest, maxHashSize)) {
+            util::logCall("CHAINSYNC", "deserializeList()", false, "Malformed Headers");
+            list.clear();
+            return false;
+        }
+    }
+    return r.left == 0;
+}
+
+void ChainSync::begin(const unsigned int nextHeight, std::vector<unsigned char> tipHash) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& [h, b] : received) {
+        delete b;
+    }
+    received.clear();
+    inFlight.clear();
+    headers.clear();
+    headersComplete = false;
+    baseHeight = nextApply = nextUnassigned = nextHeight;
+    baseHash = std::move(tipHash);
+    running = true;
+    util::logCall("CHAINSYNC", "begin()", true);
+}
+
+bool ChainSync::active() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return running;
+}
+
+bool ChainSync::complete() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return running && headersComplete && nextApply == baseHeight + headers.size();
+}
+
+void ChainSync::finish() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& [h, b] : received) {
+        delete b;
+    }
+    received.clear();
+    inFlight.clear();
+    headers.clear();
+    running = false;
+    util::logCall("CHAINSYNC", "finish()", true);
+}
+
+bool ChainSync::addHeaders(const std::vector<BlockHeader>& list) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!running) {
+        return false;
+    }
+    for (const auto& h : list) {
+        const unsigned int expected = baseHeight + static_cast<unsigned int>(headers.size());
+        const std::vector<unsigned char>& prev = headers.empty() ? baseHash : headers.back().currHash;
+        const bool links = (headers.empty() && baseHash.empty()) || h.prevHash == prev;
+        if (h.height != expected || !links || !h.hashValid()) {
+            util::logCall("CHAINSYNC", "addHeaders()", false, "Header Does Not Link");
+            return false;
+        }
+        headers.push_back(h);
+    }
+    util::logCall("CHAINSYNC", "addHeaders()", true);
+    return true;
+}
+
+void ChainSync::setHeadersDone() {
+    std::lock_guard<std::mutex> lock(mtx);
+    headersComplete = true;
+}
+
+bool ChainSync::headersDone() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return headersComplete;
+}
+
+unsigned int ChainSync::nextHeaderHeight() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return baseHeight + static_cast<unsigned int>(headers.size());
+}
+
+bool ChainSync::latestCommitment(unsigned int& height, std::vector<unsigned char>& digest) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto it = headers.rbegin(); it != headers.rend(); ++it) {
+        if (!it->snapshotDigest.empty()) {
+            height = it->height;
+            digest = it->snapshotDigest;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ChainSync::hashAt(const unsigned int height, std::vector<unsigned char>& hash) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    const BlockHeader* hdr = headerAt(height);
+    if (hdr == nullptr) {
+        return false;
+    }
+    hash = hdr->currHash;
+    return true;
+}
+
+bool ChainSync::skipTo(const unsigned int height) {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    /* Only before the first range goes out, bodies below the anchor are never fetched */
+    if (!running || !headersComplete || !inFlight.empty() || !received.empty()
+        || height < nextApply || headerAt(height) == nullptr) {
+        util::logCall("CHAINSYNC", "skipTo()", false, "Anchor Not Reachable");
+        return false;
+    }
+    nextApply = height;
+    nextUnassigned = height;
+    util::logCall("CHAINSYNC", "skipTo()", true);
+    return true;
+}
+
+const BlockHeader* ChainSync::headerAt(const unsigned int height) const {
+    if (height < baseHeight || height - baseHeight >= headers.size()) {
+        return nullptr;
+    }
+    return &headers[height - baseHeight];
+}
+
+bool ChainSync::nextRange(const uint32_t peer, const unsigned long long now, unsigned int& from, unsigned int& count) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!running || !headersComplete) {
+        return false;
+    }
+
+    auto expired = [now](const Range& r) { return r.requested == 0 || now - r.requested >= RANGE_TIMEOUT; };
+    size_t held = 0;
+    for (const auto& [first, r] : inFlight) {
+        held += r.peer == peer && !expired(r);
+    }
+    if (held >= RANGES_PER_PEER) {
+        return false;
+    }
+
+    /* A range a slow or gone peer sat on goes to this one, the lowest first since it gates applying */
+    for (auto& [first, r] : inFlight) {
+        if (expired(r)) {
+            r.peer = peer;
+            r.requested = now;
+            from = first;
+            count = r.count;
+            return true;
+        }
+    }
+
+    /* New ranges stay inside the reorder window, a slow low range holds back the rest, not memory */
+    const unsigned int end = std::min(baseHeight + static_cast<unsigned int>(headers.size()), nextApply + REORDER_WINDOW);
+    if (nextUnassigned >= end) {
+        return false;
+    }
+    from = nextUnassigned;
+    count = std::min(RANGE_SIZE, end - from);
+    inFlight.emplace(from, Range{count, peer, now, count});
+    nextUnassigned += count;
+    return true;
+}
+
+bool ChainSync::accept(Block* b) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const unsigned int h = b->getBlockHeight();
+    if (!running || h < nextApply || received.contains(h)) {
+        return false; // duplicate from a re-assigned range
+    }
+    if (h - nextApply >= REORDER_WINDOW) {
+        util::logCall("CHAINSYNC", "accept()", false, "Outside Reorder Window");
+        return false;
+    }
+    const BlockHeader* hdr = headerAt(h);
+    if (hdr == nullptr || !hdr->matches(b)) {
+        util::logCall("CHAINSYNC", "accept()", false, "Body Does Not Match Header");
+        return false;
+    }
+    received.emplace(h, b);
+
+    /* The range's peer is free for another once all of it arrived */
+    if (auto it = inFlight.upper_bound(h); it != inFlight.begin()) {
+        --it;
+        if (h < it->first + it->second.count && --it->second.remaining == 0) {
+            inFlight.erase(it);
+        }
+    }
+    return true;
+}
+
+Block* ChainSync::popReady() {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto it = received.find(nextApply);
+    if (it == received.end()) {
+        return nullptr;
+    }
+    Block* b = it->second;
+    received.erase(it);
+    nextApply++;
+
+    /* Ranges wholly applied are done, even if a late duplicate never completed them */
+    while (!inFlight.empty() && inFlight.begin()->first + inFlight.begin()->second.count <= nextApply) {
+        inFlight.erase(inFlight.begin());
+    }
+    return b;
+}
+
+size_t ChainSync::buffered() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return received.size();
+}
+
+void ChainSync::peerGone(const uint32_t peer) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& [first, r] : inFlight) {
+        if (r.peer == peer) {
+            r.requested = 0;
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef CHAINSYNC
+#define CHAINSYNC
+
+#include "util.h"
+#include "Block.h"
+#include <map>
+#include <mutex>
+
+/*-- ChainSync.h --------------------------------------------------------------
+
+  This header file defines headers-first chain download. A joining node
+  first pulls block headers (cheap, checked as a hash chain without any
+  body), then pulls bodies in ranges from every connected peer at once
+  and applies them in height order as they arrive.
+
+  BlockHeader is a block head with its height, size & hash; its hash can
+  be recomputed (Block::headHash), so a header chain is validated before
+  a single body is downloaded.
+
+  Basic operations are:
+	 begin:       Starts a sync after a local tip (or from genesis)
+	 addHeaders:  Appends a batch of headers, false if one does not link
+	 nextRange:   Next body range for an idle peer; ranges a slow or gone
+	              peer has held past the timeout are handed to another
+	 accept:      Takes a body, false (caller deletes) unless it matches
+	              the header at its height & lies inside the window
+	 popReady:    Next body in height order, nullptr if its predecessor
+	              has not arrived yet
+	 peerGone:    Releases a disconnected peer's ranges
+	 skipTo:      Starts the bodies at a verified snapshot anchor
+
+Note:
+  Out of order bodies wait in a reorder window of REORDER_WINDOW heights
+  above the next one to apply. Ranges are only handed out inside it, so
+  memory stays bounded however long the chain: at most REORDER_WINDOW
+  blocks are held, the rest are owned by the chain once applied.
+  Every member locks, the message thread delivers headers & the bodies
+  the block pipeline finished, while the block thread re-schedules
+  timed out ranges.
+-------------------------------------------------------------------------*/
+
+struct BlockHeader
+{
+	unsigned long long timestamp = 0;
+	float version = 0;
+	unsigned int height = 0;
+	size_t blockSize = 0;
+	std::vector<unsigned char> prevHash;
+	std::vector<unsigned char> merkleRoot;
+	std::vector<unsigned char> currHash;
+	std::vector<unsigned char> snapshotDigest; // empty unless the block commits to a state snapshot
+
+	static BlockHeader of(const Block* b);
+	bool hashValid() const;
+	bool matches(const Block* b) const;
+
+	/* Headers message: tSize | count | headers */
+	static std::unique_ptr<unsigned char[]> serializeList(const std::vector<BlockHeader>& list);
+	static bool deserializeList(const std::unique_ptr<unsigned char[]>& buffer, std::vector<BlockHeader>& list);
+};
+
+class ChainSync
+{
+public:
+	static constexpr unsigned int MAX_HEADERS = 2000; // per Headers message
+	static constexpr unsigned int RANGE_SIZE = 64; // bodies per range request
+	static constexpr size_t RANGES_PER_PEER = 2;
+	static constexpr unsigned long long RANGE_TIMEOUT = 10; // seconds
+	static constexpr unsigned int REORDER_WINDOW = 512; // heights buffered ahead of the next to apply
+
+	/* nextHeight: first height to download; tipHash: hash it must link to, empty from genesis */
+	void begin(unsigned int nextHeight, std::vector<unsigned char> tipHash);
+	bool active() const;
+	bool complete() const;
+	void finish();
+
+	bool addHeaders(const std::vector<BlockHeader>& list);
+	void setHeadersDone();
+	bool headersDone() const;
+	unsigned int nextHeaderHeight() const;
+
+	/* Snapshot fast sync: the highest header committing to a snapshot, a header hash,
+	   and starting the body download at a snapshot anchor instead of genesis */
+	bool latestCommitment(unsigned int& height, std::vector<unsigned char>& digest) const;
+	bool hashAt(unsigned int height, std::vector<unsigned char>& hash) const;
+	bool skipTo(unsigned int height);
+
+	bool nextRange(uint32_t peer, unsigned long long now, unsigned int& from, unsigned int& count);
+	bool accept(Block* b);
+	Block* popReady();
+	size_t buffered() const;
+	void peerGone(uint32_t peer);
+
+private:
+	struct Range
+	{
+		unsigned int count;
+		uint32_t peer;
+		unsigned long long requested; // 0 once released
+		unsigned int remaining;
+	};
+
+	/* Callers hold mtx */
+	const BlockHeader* headerAt(unsigned int height) const;
+
+	mutable std::mutex mtx;
+	bool running = false;
+	bool headersComplete = false;
+	unsigned int baseHeight = 0; // height of headers[0]
+	std::vector<unsigned char> baseHash; // hash headers[0] must link to
+	std::vector<BlockHeader> headers;
+	unsigned int nextApply = 0; // next height popReady hands out
+	unsigned int nextUnassigned = 0; // first height no range covers
+	std::map<unsigned int, Range> inFlight; // by first height
+	std::map<unsigned int, Block*> received; // bodies waiting for their predecessor
+};
+
+#endif
@@ -6,8 +6,8 @@ This file implements 0017 member functions.
 Coin::Coin() {
     totalSupply = 0;
     block_time = 5;
-    reward = 15;
-    txFee = 0.5;
+    reward = 15 * Amounts::COIN_UNITS;
+    txFee = Amounts::COIN_UNITS / 2;
     circSupply = 0;
     blkSzLimit = 1000000;
     util::logCall("COIN", "Coin()", true);
@@ -21,22 +21,26 @@ const char* Coin::getSymbol() {
     util::logCall("COIN", "getSymbol()", true);
     return symbol;
 }
-double Coin::getTotalSupply() {
+Amount Coin::getTotalSupply() {
     return totalSupply;
 }
-void Coin::setTotalSupply(double ts) {
-    totalSupply += ts;
+void Coin::setTotalSupply(Amount ts) {
+    if (!Amounts::add(totalSupply, ts, totalSupply)) {
+        util::logCall("COIN", "setTotalSupply()", false, "Supply Overflow");
+    }
 }
-double Coin::getCircSupply() {
+Amount Coin::getCircSupply() {
     return circSupply;
 }
-void Coin::setCircSupply(double cs) {
-    circSupply += cs;
+void Coin::setCircSupply(Amount cs) {
+    if (!Amounts::add(circSupply, cs, circSupply)) {
+        util::logCall("COIN", "setCircSupply()", false, "Supply Overflow");
+    }
 }
-float Coin::getReward() {
+Amount Coin::getReward() {
     return reward;
 }
-void Coin::setReward(float rw) {
+void Coin::setReward(Amount rw) {
     reward = rw;
 }
 unsigned short Coin::getBlockTime() {
@@ -45,10 +49,10 @@ unsigned short Coin::getBlockTime() {
 void Coin::setBlockTime(unsigned short bt) {
     block_time = bt;
 }
-double Coin::getTxFee() {
+Amount Coin::getTxFee() {
     return txFee;
 }
-void Coin::setTxFee(double txf) {
+void Coin::setTxFee(Amount txf) {
     txFee = txf;
 }
 uint32_t Coin::getBlkSzLimit() {
@@ -2,6 +2,7 @@
 #define COIN
 
 #include"util.h"
+#include "Amount.h"
 
 /*-- Coin.h ---------------------------------------------------------------
 
@@ -49,11 +50,11 @@ class Coin
 private:
 	const char* name = "0017";
 	const char* symbol = "0017";
-	double totalSupply;
-	double circSupply;
-	float reward;
+	Amount totalSupply;
+	Amount circSupply;
+	Amount reward;
 	unsigned short block_time;
-	double txFee;
+	Amount txFee;
 	uint32_t blkSzLimit;
 
 public:
@@ -62,16 +63,16 @@ public:
 	/* Getters and setters for Coin */
 	const char* getName();
 	const char* getSymbol();
-	double getTotalSupply();
-	void setTotalSupply(double ts);
-	double getCircSupply();
-	void setCircSupply(double cs);
-	float getReward();
-	void setReward(float rw);
+	Amount getTotalSupply();
+	void setTotalSupply(Amount ts);
+	Amount getCircSupply();
+	void setCircSupply(Amount cs);
+	Amount getReward();
+	void setReward(Amount rw);
 	unsigned short getBlockTime();
 	void setBlockTime(unsigned short bt);
-	double getTxFee();
-	void setTxFee(double txf);
+	Amount getTxFee();
+	void setTxFee(Amount txf);
 	uint32_t getBlkSzLimit();
 	void setBlkSzLimit(uint32_t bsl);
 
@@ -0,0 +1,145 @@
+/*-- CoinSelection.cpp --------------------------------------------------------
+   This file implements the wallet coin selection strategies.
+-----------------------------------------------------------------------------*/
+#include "CoinSelection.h"
+#include <limits>
+
+std::unique_ptr<CoinSelector> CoinSelector::create(const std::string& name) {
+    if (name == "oldest") return std::make_unique<OldestFirstSelector>();
+    if (name == "largest") return std::make_unique<LargestFirstSelector>();
+    if (name == "bnb") return std::make_unique<BranchAndBoundSelector>();
+    if (name == "consolidate") return std::make_unique<ConsolidationSelector>();
+    return nullptr;
+}
+
+/* Accumulates outputs from an ordered walk until target is covered */
+template <typename Walk>
+static bool greedy(Walk&& walk, const Amount target, CoinPick& picked) {
+    CoinPick chosen;
+    Amount gathered = 0;
+    walk([&](const OutPoint& out, const Amount value) {
+        chosen.emplace_back(out, value);
+        gathered += value; // bounded by the set balance, cannot overflow
+        return gathered < target;
+    });
+
+    if (gathered < target) {
+        return false;
+    }
+    picked = std::move(chosen);
+    return true;
+}
+
+bool OldestFirstSelector::select(const UtxoSet& utxos, const Amount target, CoinPick& picked) const {
+    if (target <= 0 || target > utxos.balance()) {
+        return false;
+    }
+    return greedy([&](auto&& visit) { utxos.visitByAge(visit); }, target, picked);
+}
+
+bool LargestFirstSelector::select(const UtxoSet& utxos, const Amount target, CoinPick& picked) const {
+    if (target <= 0 || target > utxos.balance()) {
+        return false;
+    }
+    return greedy([&](auto&& visit) { utxos.visitByValue(true, visit); }, target, picked);
+}
+
+bool BranchAndBoundSelector::select(const UtxoSet& utxos, const Amount target, CoinPick& picked) const {
+    if (target <= 0 || target > utxos.balance()) {
+        return false;
+    }
+
+    /* Candidates larger than the match window can never be part of a match */
+    const Amount upper = target + costOfChange;
+    CoinPick pool;
+    utxos.visitByValue(true, [&](const OutPoint& out, const Amount value) {
+        if (value <= upper) {
+            pool.emplace_back(out, value);
+        }
+        return true;
+    });
+
+    /* remaining[i] = sum of pool[i..], lets a branch be cut when it can no longer reach target */
+    std::vector<Amount> remaining(pool.size() + 1, 0);
+    for (size_t i = pool.size(); i-- > 0;) {
+        remaining[i] = remaining[i + 1] + pool[i].second;
+    }
+
+    /* Depth first search over include / exclude, descending values first */
+    std::vector<bool> include(pool.size(), false), best;
+    Amount bestWaste = std::numeric_limits<Amount>::max();
+    Amount current = 0;
+    size_t depth = 0, tries = 0;
+    while (tries++ < maxTries) {
+        bool backtrack = false;
+        if (current + remaining[depth] < target || current > upper) {
+            backtrack = true;
+        }
+        else if (current >= target) {
+            if (current - target < bestWaste) {
+                bestWaste = current - target;
+                best = include;
+                if (bestWaste == 0) break;
+            }
+            backtrack = true;
+        }
+        else if (depth == pool.size()) {
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            /* Walk back to the last included output and exclude it instead */
+            while (depth > 0 && !include[depth - 1]) {
+                depth--;
+            }
+            if (depth == 0) break;
+            depth--;
+            include[depth] = false;
+            current -= pool[depth].second;
+            depth++;
+        }
+        else {
+            include[depth] = true;
+            current += pool[depth].second;
+            depth++;
+        }
+    }
+
+    if (best.empty()) {
+        util::logCall("COINSELECTION", "select()", true, "No Exact Match, Largest First");
+        return LargestFirstSelector().select(utxos, target, picked);
+    }
+
+    CoinPick chosen;
+    for (size_t i = 0; i < best.size(); i++) {
+        if (best[i]) {
+            chosen.emplace_back(std::move(pool[i]));
+        }
+    }
+    picked = std::move(chosen);
+    return true;
+}
+
+bool ConsolidationSelector::select(const UtxoSet& utxos, const Amount target, CoinPick& picked) const {
+    if (target <= 0 || target > utxos.balance()) {
+        return false;
+    }
+
+    /* Smallest first; once target is covered keep sweeping until maxInputs */
+    CoinPick chosen;
+    Amount gathered = 0;
+    utxos.visitByValue(false, [&](const OutPoint& out, const Amount value) {
+        if (gathered >= target && chosen.size() >= maxInputs) {
+            return false;
+        }
+        chosen.emplace_back(out, value);
+        gathered += value;
+        return true;
+    });
+
+    if (gathered < target) {
+        return false;
+    }
+    picked = std::move(chosen);
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef COINSELECTION
+#define COINSELECTION
+
+#include "UtxoSet.h"
+
+/*-- CoinSelection.h ----------------------------------------------------------
+
+  This header file defines the coin selection strategies a Wallet can use
+  to pick the outputs funding a spend. Every strategy works on the ordered
+  indexes of a UtxoSet and only visits the outputs it considers.
+
+  Strategies are:
+	 oldest:       Oldest outputs first (historical behaviour, default)
+	 largest:      Largest outputs first, fewest inputs per spend
+	 bnb:          Branch and bound search for an input set matching the
+	               target within costOfChange; the excess of a match goes
+	               to the fee, so no change is minted. Falls back to largest-first when no match is found
+	 consolidate:  Smallest outputs first, then keeps sweeping small
+	               outputs up to maxInputs so dust merges into one change
+
+Note:
+  picked is only written when a selection covering target exists.
+-------------------------------------------------------------------------*/
+
+using CoinPick = std::vector<std::pair<OutPoint, Amount>>;
+
+class CoinSelector
+{
+public:
+	virtual ~CoinSelector() = default;
+
+	virtual const char* name() const = 0;
+	virtual bool select(const UtxoSet& utxos, Amount target, CoinPick& picked) const = 0;
+
+	/* Excess over target too small to be worth a change output, the spend pays it as fee */
+	virtual Amount changeWindow() const { return 0; }
+
+	/* Build a strategy from its name, nullptr if unknown */
+	static std::unique_ptr<CoinSelector> create(const std::string& name);
+};
+
+class OldestFirstSelector : public CoinSelector
+{
+public:
+	const char* name() const override { return "oldest"; }
+	bool select(const UtxoSet& utxos, Amount target, CoinPick& picked) const override;
+};
+
+class LargestFirstSelector : public CoinSelector
+{
+public:
+	const char* name() const override { return "largest"; }
+	bool select(const UtxoSet& utxos, Amount target, CoinPick& picked) const override;
+};
+
+class BranchAndBoundSelector : public CoinSelector
+{
+public:
+	explicit BranchAndBoundSelector(Amount costOfChange = Amounts::COIN_UNITS / 1000, size_t maxTries = 100000)
+		: costOfChange(costOfChange), maxTries(maxTries) {}
+
+	const char* name() const override { return "bnb"; }
+	bool select(const UtxoSet& utxos, Amount target, CoinPick& picked) const override;
+	Amount changeWindow() const override { return costOfChange; }
+
+private:
+	Amount costOfChange;
+	size_t maxTries;
+};
+
+class ConsolidationSelector : public CoinSelector
+{
+public:
+	explicit ConsolidationSelector(size_t maxInputs = 50) : maxInputs(maxInputs) {}
+
+	const char* name() const override { return "consolidate"; }
+	bool select(const UtxoSet& utxos, Amount target, CoinPick& picked) const override;
+
+private:
+	size_t maxInputs;
+};
+
+#endif
@@ -0,0 +1,273 @@
+/*-- CompactBlock.cpp ---------------------------------------------------------
+   This file implements compact block relay & reconstruction.
+-----------------------------------------------------------------------------*/
+#include "CompactBlock.h"
+#include "ByteIO.h"
+
+namespace {
+    constexpr size_t maxHashSize = 256;
+}
+
+bool CompactBlock::fromBlock(const Block* b, const uint64_t nonce, CompactBlock& out) {
+    const std::vector<transactions> txs = b->getData();
+    if (txs.empty()) {
+        util::logCall("COMPACTBLOCK", "fromBlock()", false, "Empty Block");
+        return false;
+    }
+
+    out.timestamp = b->getTimestamp();
+    out.version = b->getVersion();
+    out.height = b->getBlockHeight();
+    out.prevHash = b->getPrevHash();
+    out.merkleRoot = b->getMerkleRoot();
+    out.currHash = b->getCurrHash();
+    out.snapshotDigest = b->getSnapshotDigest();
+    out.nonce = nonce;
+    out.computeKey();
+
+    const std::unique_ptr<unsigned char[]> cbBuf = txs.front().serialize();
+    size_t cbSize = 0;
+    std::memcpy(&cbSize, cbBuf.get(), sizeof(size_t));
+    out.coinbase.assign(cbBuf.get(), cbBuf.get() + cbSize);
+
+    out.shortIds.clear();
+    out.shortIds.reserve(txs.size() - 1);
+    for (size_t i = 1; i < txs.size(); i++) {
+        out.shortIds.push_back(out.shortId(txs[i].getTxid()));
+    }
+    util::logCall("COMPACTBLOCK", "fromBlock()", true);
+    return true;
+}
+
+void CompactBlock::computeKey() {
+    ByteWriter seed;
+    seed.put(currHash.data(), currHash.size());
+    seed.put(&nonce, sizeof(nonce));
+    SHA256(seed.body.data(), seed.body.size(), key.data());
+}
+
+uint64_t CompactBlock::shortId(const std::string& txid) const {
+    std::vector<unsigned char> raw;
+    util::fromHex(txid, raw);
+
+    unsigned char msg[32 + 64] = {};
+    const size_t rawSize = std::min<size_t>(raw.size(), 64);
+    std::memcpy(msg, key.data(), key.size());
+    std::memcpy(msg + key.size(), raw.data(), rawSize);
+
+    unsigned char d[SHA256_DIGEST_LENGTH];
+    SHA256(msg, key.size() + rawSize, d);
+    uint64_t id = 0;
+    std::memcpy(&id, d, SHORTID_SIZE);
+    return id;
+}
+
+std::unique_ptr<unsigned char[]> CompactBlock::serialize() const {
+    /* Layout: tSize | timestamp | version | height | nonce | prevHash | merkleRoot | currHash | snapshotDigest | coinbase | count | short IDs */
+    ByteWriter w;
+    w.body.reserve(256 + coinbase.size() + shortIds.size() * SHORTID_SIZE);
+    w.put(&timestamp, sizeof(timestamp));
+    w.put(&version, sizeof(version));
+    w.put(&height, sizeof(height));
+    w.put(&nonce, sizeof(nonce));
+    w.bytes(prevHash);
+    w.bytes(merkleRoot);
+    w.bytes(currHash);
+    w.bytes(snapshotDigest);
+    w.bytes(coinbase);
+    const size_t count = shortIds.size();
+    w.put(&count, sizeof(size_t));
+    for (const uint64_t id : shortIds) {
+        w.put(&id, SHORTID_SIZE);
+    }
+    return w.finish();
+}
+
+bool CompactBlock::deserialize(const std::unique_ptr<unsigned char[]>& buffer, CompactBlock& out) {
+    ByteReader r;
+    size_t count = 0;
+    if (!r.open(buffer)
+        || !r.read(&out.timestamp, sizeof(out.timestamp))
+        || !r.read(&out.version, sizeof(out.version))
+        || !r.read(&out.height, sizeof(out.height))
+        || !r.read(&out.nonce, sizeof(out.nonce))
+        || !r.bytes(out.prevHash, maxHashSize)
+        || !r.bytes(out.merkleRoot, maxHashSize)
+        || !r.bytes(out.currHash, maxHashSize)
+        || !r.bytes(out.snapshotDigest, maxHashSize)
+        || !r.bytes(out.coinbase, r.left)
+        || !r.read(&count, sizeof(size_t))
+        || count > MAX_TXS || count * SHORTID_SIZE != r.left) {
+        util::logCall("COMPACTBLOCK", "deserialize()", false, "Malformed Compact Block");
+        return false;
+    }
+
+    /* The coinbase must be one whole tx buffer */
+    size_t cbSize = 0;
+    if (out.coinbase.size() < sizeof(size_t)
+        || (std::memcpy(&cbSize, out.coinbase.data(), sizeof(size_t)), cbSize != out.coinbase.size())) {
+        util::logCall("COMPACTBLOCK", "deserialize()", false, "Malformed Coinbase");
+        return false;
+    }
+
+    out.shortIds.assign(count, 0);
+    for (auto& id : out.shortIds) {
+        r.read(&id, SHORTID_SIZE);
+    }
+    out.computeKey();
+    return true;
+}
+
+std::unique_ptr<unsigned char[]> CompactBlock::serializeRequest(const unsigned int height, const std::vector<unsigned char>& hash,
+    const std::vector<uint32_t>& indices) {
+    ByteWriter w;
+    w.put(&height, sizeof(height));
+    w.bytes(hash);
+    const size_t count = indices.size();
+    w.put(&count, sizeof(size_t));
+    w.put(indices.data(), count * sizeof(uint32_t));
+    return w.finish();
+}
+
+bool CompactBlock::deserializeRequest(const std::unique_ptr<unsigned char[]>& buffer, unsigned int& height,
+    std::vector<unsigned char>& hash, std::vector<uint32_t>& indices) {
+    ByteReader r;
+    size_t count = 0;
+    if (!r.open(buffer) || !r.read(&height, sizeof(height)) || !r.bytes(hash, maxHashSize)
+        || !r.read(&count, sizeof(size_t)) || count > MAX_TXS || count * sizeof(uint32_t) != r.left) {
+        util::logCall("COMPACTBLOCK", "deserializeRequest()", false, "Malformed Request");
+        return false;
+    }
+    indices.assign(count, 0);
+    return r.read(indices.data(), count * sizeof(uint32_t));
+}
+
+std::unique_ptr<unsigned char[]> CompactBlock::serializeTxs(const std::vector<unsigned char>& hash,
+    const std::vector<uint32_t>& indices, const std::vector<transactions>& txs) {
+    ByteWriter w;
+    w.bytes(hash);
+    const size_t count = std::min(indices.size(), txs.size());
+    w.put(&count, sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        w.put(&indices[i], sizeof(uint32_t));
+        w.buffer(txs[i].serialize());
+    }
+    return w.finish();
+}
+
+bool CompactBlock::deserializeTxs(const std::unique_ptr<unsigned char[]>& buffer, std::vector<unsigned char>& hash,
+    std::vector<uint32_t>& indices, std::vector<std::unique_ptr<unsigned char[]>>& txs) {
+    ByteReader r;
+    size_t count = 0;
+    indices.clear();
+    txs.clear();
+    if (!r.open(buffer) || !r.bytes(hash, maxHashSize) || !r.read(&count, sizeof(size_t)) || count > MAX_TXS) {
+        util::logCall("COMPACTBLOCK", "deserializeTxs()", false, "Malformed Block Txs");
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = 0;
+        std::unique_ptr<unsigned char[]> tx;
+        if (!r.read(&index, sizeof(uint32_t)) || !r.buffer(tx)) {
+            util::logCall("COMPACTBLOCK", "deserializeTxs()", false, "Malformed Block Txs");
+            return false;
+        }
+        indices.push_back(index);
+        txs.push_back(std::move(tx));
+    }
+    return r.left == 0;
+}
+
+PartialBlock::PartialBlock(CompactBlock compact)
+    : cb(std::move(compact)),
+    slots(cb.shortIds.size())
+{
+}
+
+const CompactBlock& PartialBlock::getCompact() const {
+    return cb;
+}
+
+size_t PartialBlock::fill(const Mempool& pool) {
+    /* short ID -> slot, ids repeated inside the block itself can only be requested */
+    constexpr size_t ambiguous = SIZE_MAX;
+    std::unordered_map<uint64_t, size_t> wanted;
+    wanted.reserve(cb.shortIds.size());
+    for (size_t i = 0; i < cb.shortIds.size(); i++) {
+        if (!slots[i]) {
+            auto [it, inserted] = wanted.try_emplace(cb.shortIds[i], i);
+            if (!inserted) it->second = ambiguous;
+        }
+    }
+
+    /* Two pool txs on one short ID: neither is trusted, the slot is requested */
+    std::unordered_map<size_t, size_t> hits;
+    pool.visit([&](const transactions& tx) {
+        const auto it = wanted.find(cb.shortId(tx.getTxid()));
+        if (it == wanted.end() || it->second == ambiguous) {
+            return true;
+        }
+        if (++hits[it->second] == 1) {
+            slots[it->second] = std::make_unique<transactions>(tx);
+        }
+        else {
+            slots[it->second].reset();
+        }
+        return true;
+    });
+
+    size_t filled = 0;
+    for (const auto& [slot, n] : hits) {
+        filled += n == 1;
+    }
+    util::logCall("COMPACTBLOCK", "fill()", true);
+    return filled;
+}
+
+std::vector<uint32_t> PartialBlock::missing() const {
+    std::vector<uint32_t> out;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (!slots[i]) {
+            out.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    return out;
+}
+
+bool PartialBlock::provide(const uint32_t index, const transactions& tx) {
+    if (index == 0 || index > slots.size() || cb.shortId(tx.getTxid()) != cb.shortIds[index - 1]) {
+        util::logCall("COMPACTBLOCK", "provide()", false, "Unexpected Tx");
+        return false;
+    }
+    slots[index - 1] = std::make_unique<transactions>(tx);
+    return true;
+}
+
+Block* PartialBlock::build() const {
+    std::vector<transactions> txs;
+    txs.reserve(slots.size() + 1);
+
+    std::optional<transactions> coinbase;
+    if (!transactions::decode(cb.coinbase, coinbase)) {
+        util::logCall("COMPACTBLOCK", "build()", false, "Malformed Coinbase");
+        return nullptr;
+    }
+    txs.push_back(*coinbase);
+    for (const auto& s : slots) {
+        if (!s) {
+            util::logCall("COMPACTBLOCK", "build()", false, "Txs Missing");
+            return nullptr;
+        }
+        txs.push_back(*s);
+    }
+
+    /* The Merkle root is recomputed, a wrong tx on a colliding short ID shows up here */
+    Block* b = new Block(txs, Block::MerkleRoot(txs), cb.prevHash, cb.version, cb.height, cb.timestamp, cb.snapshotDigest);
+    if (b->getMerkleRoot() != cb.merkleRoot || b->getCurrHash() != cb.currHash) {
+        util::logCall("COMPACTBLOCK", "build()", false, "Reconstruction Mismatch");
+        delete b;
+        return nullptr;
+    }
+    util::logCall("COMPACTBLOCK", "build()", true);
+    return b;
+}
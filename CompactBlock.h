@@ -0,0 +1,98 @@
+#ifndef COMPACTBLOCK
+#define COMPACTBLOCK
+
+#include "util.h"
+#include "Block.h"
+#include "Mempool.h"
+
+/*-- CompactBlock.h -----------------------------------------------------------
+
+  This header file defines compact block relay. A compact block is a
+  block head plus its coinbase in full and a 6 byte short ID for every
+  other transaction. Peers usually hold those txs in their mempool
+  already, so a block costs a few bytes per tx on the wire.
+
+  Short IDs are the first 6 bytes of SHA-256(key || raw txid), the key
+  being SHA-256(block hash || nonce) with a random nonce per
+  announcement, so txids cannot be ground to collide on every link.
+
+  Basic operations are:
+	 fromBlock:    Compact form of a linked block
+	 serialize:    Wire form, deserialize bounds checks it
+	 shortId:      Short ID of a txid under this block's key
+
+  PartialBlock rebuilds the block on the receiving side:
+	 fill:         Takes matching txs from the mempool, ambiguous short
+	               IDs (two pool txs) are left missing
+	 missing:      Indices still to be requested (GetBlockTxs)
+	 provide:      Supplies a requested tx, false if its short ID differs
+	 build:        The block, nullptr if the Merkle root or hash does not
+	               match (short ID collision: fall back to the full block)
+
+Note:
+  Index 0 (coinbase) is always sent in full. Indices in requests count
+  from 1 up to the number of txs in the block.
+-------------------------------------------------------------------------*/
+
+class CompactBlock
+{
+public:
+	static constexpr size_t SHORTID_SIZE = 6;
+	static constexpr size_t MAX_TXS = 1000000;
+
+	/* Head */
+	unsigned long long timestamp = 0;
+	float version = 0;
+	unsigned int height = 0;
+	std::vector<unsigned char> prevHash;
+	std::vector<unsigned char> merkleRoot;
+	std::vector<unsigned char> currHash;
+	std::vector<unsigned char> snapshotDigest;
+
+	uint64_t nonce = 0;
+	std::vector<unsigned char> coinbase; // serialized first tx
+	std::vector<uint64_t> shortIds; // txs 1..n
+
+	static bool fromBlock(const Block* b, uint64_t nonce, CompactBlock& out);
+
+	std::unique_ptr<unsigned char[]> serialize() const;
+	static bool deserialize(const std::unique_ptr<unsigned char[]>& buffer, CompactBlock& out);
+
+	/* Needs computeKey() after the head & nonce are set */
+	uint64_t shortId(const std::string& txid) const;
+	void computeKey();
+
+	/* GetBlockTxs: height | block hash | indices */
+	static std::unique_ptr<unsigned char[]> serializeRequest(unsigned int height, const std::vector<unsigned char>& hash,
+		const std::vector<uint32_t>& indices);
+	static bool deserializeRequest(const std::unique_ptr<unsigned char[]>& buffer, unsigned int& height,
+		std::vector<unsigned char>& hash, std::vector<uint32_t>& indices);
+
+	/* BlockTxs: block hash | (index, serialized tx) pairs */
+	static std::unique_ptr<unsigned char[]> serializeTxs(const std::vector<unsigned char>& hash,
+		const std::vector<uint32_t>& indices, const std::vector<transactions>& txs);
+	static bool deserializeTxs(const std::unique_ptr<unsigned char[]>& buffer, std::vector<unsigned char>& hash,
+		std::vector<uint32_t>& indices, std::vector<std::unique_ptr<unsigned char[]>>& txs);
+
+private:
+	std::array<unsigned char, 32> key{};
+};
+
+class PartialBlock
+{
+public:
+	explicit PartialBlock(CompactBlock cb);
+
+	const CompactBlock& getCompact() const;
+
+	size_t fill(const Mempool& pool);
+	std::vector<uint32_t> missing() const;
+	bool provide(uint32_t index, const transactions& tx);
+	Block* build() const;
+
+private:
+	CompactBlock cb;
+	std::vector<std::unique_ptr<transactions>> slots; // slot i holds tx i + 1
+};
+
+#endif
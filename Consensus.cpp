@@ -3,11 +3,13 @@
 //
 
 #include "Consensus.h"
+#include <cmath>
 
 Consensus::Consensus()
 {
     timestamp = util::TimeStamp();
     lastUpd = timestamp;
+    seenEpoch = lastUpd;
     votingPeriod = 0;
     windowPeriod = 240;
     minBalance = 0;
@@ -16,7 +18,12 @@ Consensus::Consensus()
 }
 
 bool Consensus::delIDExist(const std::string &ID) const {
-    return std::ranges::find(delegates, ID) != delegates.end();
+    const IdHandle h = Interner::find(ID);
+    return h != Interner::NONE && delIDExist(h);
+}
+
+bool Consensus::delIDExist(const IdHandle ID) const {
+    return knownIDs.contains(ID);
 }
 
 std::string Consensus::genDelegateID(){
@@ -102,50 +109,97 @@ std::string Consensus::genDelegateID(){
 
     }while (delIDExist(delID));
 
-    delegateID.push_back(delID);
+    addDelegateID(delID);
     util::logCall("CONSENSUS", "genDelegateID()", true);
     return delID;
 }
 
 std::vector<std::string>  Consensus::getDelegates() {
     std::lock_guard<std::mutex> lock(delegatesMutex);
-    return delegates;
+    return Interner::str(delegates);
 }
 
 void Consensus::setDelegates(const std::vector<std::string>& dels) {
+    std::vector<IdHandle> ids = Interner::intern(dels);
     std::lock_guard<std::mutex> lock(delegatesMutex);
-    delegates = dels;
+    delegates = std::move(ids);
 }
 
 std::vector<std::string> Consensus::getDelegateIDs() {
-    return delegateID;
+    return Interner::str(delegateID);
 }
 
 void Consensus::setDelegateIDs(const std::vector<std::string> &delIDs) {
     std::lock_guard<std::mutex> lock(delegatesMutex);
     for (auto& id : delIDs) {
-        if (delIDExist(id)) {
-            continue;
-        }
-        else {
-            delegateID.push_back(id);
-        }
+        addDelegateID(id);
     }
 }
 
 void Consensus::addDelegateID(const std::string& delegate_id) {
-    delegateID.push_back(delegate_id);
+    /* knownIDs keeps delegateID free of duplicates */
+    if (const IdHandle h = Interner::intern(delegate_id); knownIDs.insert(h).second) {
+        delegateID.push_back(h);
+    }
+}
+
+std::vector<std::tuple<Address, std::string, float>> Consensus::getVotesQueue() {
+    std::lock_guard<std::mutex> lock(votesMutex);
+    std::vector<std::tuple<Address, std::string, float>> out;
+    out.reserve(votesQueue.size());
+    for (const auto& [voter, del, weight] : votesQueue) {
+        out.emplace_back(voter, Interner::str(del), weight);
+    }
+    return out;
 }
 
-std::vector<std::tuple<std::string, std::string, float>> Consensus::getVotesQueue() {
+std::vector<std::tuple<Address, IdHandle, float>> Consensus::getVotesQueueIDs() {
+    std::lock_guard<std::mutex> lock(votesMutex);
     return votesQueue;
 }
 
-std::tuple<bool, std::string> Consensus::requestDelegate(const double balance) {
+size_t Consensus::getVotesQueueSize() {
+    std::lock_guard<std::mutex> lock(votesMutex);
+    return votesQueue.size();
+}
+
+std::vector<std::tuple<Address, IdHandle, float>> Consensus::filterNewVotes(const std::vector<std::tuple<Address, std::string, float>>& votes) {
+    std::lock_guard<std::mutex> lock(votesMutex);
+
+    /* A new voting epoch starts with an empty seen set, keeping it bounded */
+    if (seenEpoch != lastUpd) {
+        seenVotes.clear();
+        seenEpoch = lastUpd;
+    }
+
+    std::vector<std::tuple<Address, IdHandle, float>> fresh;
+    fresh.reserve(votes.size());
+    for (const auto& [voter, del, weight] : votes) {
+        /* NaN, infinite & negative weights are no votes; -0 is taken as 0 so both share one key */
+        if (!std::isfinite(weight) || weight < 0) {
+            continue;
+        }
+        /* Votes name delegates by ID, one never interned is unknown here & would only grow the table */
+        const IdHandle d = Interner::find(del);
+        if (d == Interner::NONE) {
+            continue;
+        }
+        const float w = weight + 0.0f;
+        if (seenVotes.insert(VoteKey{voter, d, w, seenEpoch}).second) {
+            fresh.emplace_back(voter, d, w);
+        }
+    }
+
+    util::logCall("CONSENSUS", "filterNewVotes()", true);
+    return fresh;
+}
+
+std::tuple<bool, std::string> Consensus::requestDelegate(const Amount balance) {
     std::lock_guard<std::mutex> lock(delegatesMutex);
-    if (balance >= minBalance) {
+    Amount required = 0;
+    if (Amounts::fromCoins(minBalance, required) && balance >= required) {
         const std::string id = genDelegateID();
-        delegates.push_back(id);
+        delegates.push_back(Interner::intern(id));
         util::logCall("CONSENSUS", "requestDelegate()", true);
         return {true, id};
     }
@@ -156,13 +210,45 @@ std::tuple<bool, std::string> Consensus::requestDelegate(const double balance) {
     }
 }
 
-void Consensus::updatedVotes(const std::vector<std::tuple<std::string, std::string, float>>& votes) {
-    for (auto& vote : votes) {
-        votesQueue.emplace_back(vote);
+void Consensus::updatedVotes(const std::vector<std::tuple<Address, std::string, float>>& votes) {
+    std::lock_guard<std::mutex> lock(votesMutex);
+    votesQueue.reserve(votesQueue.size() + votes.size());
+    for (auto& [voter, del, weight] : votes) {
+        votesQueue.emplace_back(voter, Interner::intern(del), weight);
     }
     util::logCall("CONSENSUS", "updatedVotes()", true);
 }
 
+void Consensus::updatedVotes(const std::vector<std::tuple<Address, IdHandle, float>>& votes) {
+    std::lock_guard<std::mutex> lock(votesMutex);
+    votesQueue.insert(votesQueue.end(), votes.begin(), votes.end());
+    util::logCall("CONSENSUS", "updatedVotes()", true);
+}
+
+void Consensus::revokeVotes(const std::vector<std::tuple<Address, IdHandle, float>>& votes) {
+    std::lock_guard<std::mutex> lock(votesMutex);
+    for (auto v = votes.rbegin(); v != votes.rend(); ++v) {
+        /* Appended last, so searched from the back */
+        if (const auto it = std::find(votesQueue.rbegin(), votesQueue.rend(), *v); it != votesQueue.rend()) {
+            votesQueue.erase(std::next(it).base());
+        }
+        const auto& [voter, del, weight] = *v;
+        seenVotes.erase(VoteKey{voter, del, weight, seenEpoch});
+    }
+    util::logCall("CONSENSUS", "revokeVotes()", true);
+}
+
+void Consensus::removeDelegateIDs(const std::vector<std::string>& ids) {
+    std::lock_guard<std::mutex> lock(delegatesMutex);
+    for (const auto& id : ids) {
+        const IdHandle h = Interner::find(id);
+        if (h != Interner::NONE && knownIDs.erase(h) > 0) {
+            std::erase(delegateID, h);
+        }
+    }
+    util::logCall("CONSENSUS", "removeDelegateIDs()", true);
+}
+
 void Consensus::setTimestamp(const unsigned long long ts) {
     timestamp = ts;
 }
@@ -217,12 +303,20 @@ void Consensus::setMinBalance(const float mb) {
 }
 
 std::string Consensus::getCurrentDelegate() {
-    std::lock_guard<std::mutex> lock(delegatesMutex);
-    if (delegates.empty()) {
+    const IdHandle current = getCurrentDelegateID();
+    if (current == Interner::NONE) {
         std::string error = "error";
         return error;
     }
-    std::string currentDelegate = std::move(delegates.front());
+    return Interner::str(current);
+}
+
+IdHandle Consensus::getCurrentDelegateID() {
+    std::lock_guard<std::mutex> lock(delegatesMutex);
+    if (delegates.empty()) {
+        return Interner::NONE;
+    }
+    const IdHandle currentDelegate = delegates.front();
     delegates.erase(delegates.begin());
     return currentDelegate;
 }
@@ -230,32 +324,40 @@ std::string Consensus::getCurrentDelegate() {
 void Consensus::updateDelegates() {
     if (const unsigned long long timeNow = util::TimeStamp(); timeNow - lastUpd >= votingPeriod) {
         std::lock_guard<std::mutex> lock(delegatesMutex);
+        std::lock_guard<std::mutex> votesLock(votesMutex);
 
         /* Process Vote Decay */
-        std::map<std::pair<std::string, std::string>, std::vector<float>> votesContain; // temp container
-
-        /* Populate Temp Container <Map> 7 track Occurrences */
-        std::map<std::pair<std::string, std::string>, size_t> first_Occur;
+        /* (voter, delegate) pair as key, weight & epoch left at zero */
+        auto key = [](const Address& a, IdHandle b) { return VoteKey{a, b}; };
+        std::unordered_map<VoteKey, size_t, VoteKeyHash> occurrences; // temp container
+        std::unordered_map<VoteKey, size_t, VoteKeyHash> first_Occur;
+        occurrences.reserve(votesQueue.size());
+        first_Occur.reserve(votesQueue.size());
+
+        /* Populate Temp Container <Map> & track Occurrences */
         for (size_t i = 0; i < votesQueue.size(); i++) {
-            auto[a, b, vote] = votesQueue[i];
-            votesContain[{a, b}].emplace_back(vote);
+            const auto& [a, b, vote] = votesQueue[i];
+            occurrences[key(a, b)]++;
 
             /* Track First Occurrence */
-            if (!first_Occur.contains({a, b})) {
-                first_Occur[{a, b}] = i;
-            }
+            first_Occur.try_emplace(key(a, b), i);
         }
 
-        /* Vote Decay */
-        for (const auto& [key, value] : votesContain) {
-            if (value.size() > 1) {
-                votesQueue.erase(votesQueue.begin() + first_Occur[key]);
+        /* Vote Decay, superseded first votes are dropped once the loop is done */
+        std::vector<size_t> superseded;
+        for (const auto& [k, count] : occurrences) {
+            if (count > 1) {
+                superseded.push_back(first_Occur[k]);
             }
             else {
-                auto& entry = votesQueue[first_Occur[key]];
+                auto& entry = votesQueue[first_Occur[k]];
                 std::get<2>(entry) *= decayFactor;
             }
         }
+        std::ranges::sort(superseded, std::greater<>());
+        for (const size_t pos : superseded) {
+            votesQueue.erase(votesQueue.begin() + pos);
+        }
 
         /* Process Vote Window <sort> */
         std::ranges::sort(votesQueue, [](const auto& a, const auto& b) {
@@ -265,15 +367,15 @@ void Consensus::updateDelegates() {
         /* Create Helper Vector for top voted delegates*/
         if (votesQueue.size() > maxDelegates) {
             /* votes in queue surpasses maximum delegates*/
-            std::vector<std::string> topDelegates;
+            std::vector<IdHandle> topDelegates;
             topDelegates.reserve(maxDelegates);
             for (unsigned short i = 0; i < maxDelegates; i++) {
                 topDelegates.emplace_back(std::get<1>(votesQueue[i]));
             }
 
             /* Create vector for Current Window */
-            std::vector<std::string> currentWindow;
-            currentWindow.reserve(maxDelegates * votingPeriod);
+            std::vector<IdHandle> currentWindow;
+            currentWindow.reserve(maxDelegates * windowPeriod);
 
             /* Add top Delegates To Window Period */
             for (unsigned short round = 0; round < windowPeriod; round++) {
@@ -286,15 +388,15 @@ void Consensus::updateDelegates() {
         }
         else {
             /* votes in queue <= maximum delegates*/
-            std::vector<std::string> topDelegates;
+            std::vector<IdHandle> topDelegates;
             topDelegates.reserve(votesQueue.size());
             for (unsigned short i = 0; i < votesQueue.size(); i++) {
                 topDelegates.emplace_back(std::get<1>(votesQueue[i]));
             }
 
             /* votes in queue is less than or = maximum allowed delegates */
-            std::vector<std::string> currentWindow;
-            currentWindow.reserve(votesQueue.size() * votingPeriod);
+            std::vector<IdHandle> currentWindow;
+            currentWindow.reserve(votesQueue.size() * windowPeriod);
 
             /* Add top Delegates To Window Period */
             for (unsigned short round = 0; round < windowPeriod; round++) {
@@ -310,140 +412,33 @@ void Consensus::updateDelegates() {
 }
 
 std::unique_ptr<unsigned char[]> Consensus::serializeConsensus() {
-    size_t tSize = sizeof(size_t) + sizeof(unsigned long long) + sizeof(unsigned long long) + sizeof(unsigned long);
-    tSize += sizeof(unsigned short) + sizeof(unsigned short) + sizeof(float) + sizeof(float);
-
-    std::unique_ptr<unsigned char[]> Buffer(new unsigned char[tSize]);
-
-    size_t offset = 0;
-    std::memcpy(Buffer.get() + offset, &tSize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    std::memcpy(Buffer.get() + offset, &timestamp, sizeof(unsigned long long));
-    offset += sizeof(unsigned long long);
-
-    std::memcpy(Buffer.get() + offset, &lastUpd, sizeof(unsigned long long));
-    offset += sizeof(unsigned long long);
-
-    std::memcpy(Buffer.get() + offset, &votingPeriod, sizeof(unsigned long));
-    offset += sizeof(unsigned long);
-
-    std::memcpy(Buffer.get() + offset, &windowPeriod, sizeof(unsigned short));
-    offset += sizeof(unsigned short);
-
-    std::memcpy(Buffer.get() + offset, &maxDelegates, sizeof(unsigned short));
-    offset += sizeof(unsigned short);
-
-    std::memcpy(Buffer.get() + offset, &decayFactor, sizeof(float));
-    offset += sizeof(float);
-
-    std::memcpy(Buffer.get() + offset, &minBalance, sizeof(float));
-
-    return Buffer;
-}
-
-std::tuple<unsigned long long, unsigned long long, unsigned long,
-unsigned short, unsigned short, float, float> Consensus::deserializeConsensus(const std::unique_ptr<unsigned char[]>& data) {
-
-    /* Variables */
-    unsigned long long timestamp;
-    unsigned long long lastUpd;
-    unsigned long votingPeriod;
-    unsigned short windowPeriod;
-    unsigned short maxDelegates;
-    float decayFactor;
-    float minBalance;
-    size_t tSize;
-
-    size_t offset = 0;
-    std::memcpy(&tSize, data.get(), sizeof(size_t));
-    offset += sizeof(size_t);
-
-    std::memcpy(&timestamp, data.get() + offset, sizeof(unsigned long long));
-    offset += sizeof(unsigned long long);
-
-    std::memcpy(&lastUpd, data.get() + offset, sizeof(unsigned long long));
-    offset += sizeof(unsigned long long);
-
-    std::memcpy(&votingPeriod, data.get() + offset, sizeof(unsigned long));
-    offset += sizeof(unsigned long);
-
-    std::memcpy(&windowPeriod, data.get() + offset, sizeof(unsigned short));
-    offset += sizeof(unsigned short);
-
-    std::memcpy(&maxDelegates, data.get() + offset, sizeof(unsigned short));
-    offset += sizeof(unsigned short);
-
-    std::memcpy(&decayFactor, data.get() + offset, sizeof(float));
-    offset += sizeof(float);
-
-    std::memcpy(&minBalance, data.get() + offset, sizeof(float));
-
-    std::tuple<unsigned long long, unsigned long long, unsigned long, unsigned short, unsigned short, float,
-    float>consensus(timestamp, lastUpd, votingPeriod, windowPeriod, maxDelegates, decayFactor, minBalance);
-
-    return consensus;
+    return Wire::encode(*this);
 }
 
-std::unique_ptr<unsigned char[]> Consensus::serializeVector(const std::vector<std::tuple<std::string, std::string, float>>& vec) {
-    std::vector<unsigned char> buffer;
-    size_t totalSize = sizeof(size_t);  // Reserve space for total buffer size
-
-    size_t numTuples = vec.size();
-    buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&numTuples), reinterpret_cast<unsigned char*>(&numTuples) + sizeof(numTuples));
-    totalSize += sizeof(numTuples);
-
-    auto appendString = [&](const std::string& str) {
-        uint32_t length = str.length();
-        totalSize += sizeof(length) + length;
-        buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&length), reinterpret_cast<unsigned char*>(&length) + sizeof(length));
-        buffer.insert(buffer.end(), str.begin(), str.end());
-    };
-
-    for (const auto& tup : vec) {
-        appendString(std::get<0>(tup));
-        appendString(std::get<1>(tup));
-
-        float value = std::get<2>(tup);
-        buffer.insert(buffer.end(), reinterpret_cast<unsigned char*>(&value), reinterpret_cast<unsigned char*>(&value) + sizeof(value));
-        totalSize += sizeof(value);
+bool Consensus::deserializeConsensus(const std::unique_ptr<unsigned char[]>& data, std::tuple<unsigned long long,
+    unsigned long long, unsigned long, unsigned short, unsigned short, float, float>& out) {
+    Wire::Decoded d;
+    if (!Wire::decode(data, d)) {
+        util::logCall("CONSENSUS", "deserializeConsensus()", false, "Malformed Consensus");
+        return false;
     }
 
-    // Allocate heap memory for serialization
-    std::unique_ptr<unsigned char[]> serializedData(new unsigned char[totalSize]);
-    std::memcpy(serializedData.get(), &totalSize, sizeof(totalSize));  // Store total buffer size
-    std::memcpy(serializedData.get() + sizeof(totalSize), buffer.data(), buffer.size());
-
-    return serializedData;
+    out = std::make_tuple(Wire::at<&Consensus::timestamp>(d), Wire::at<&Consensus::lastUpd>(d),
+        Wire::at<&Consensus::votingPeriod>(d), Wire::at<&Consensus::windowPeriod>(d), Wire::at<&Consensus::maxDelegates>(d),
+        Wire::at<&Consensus::decayFactor>(d), Wire::at<&Consensus::minBalance>(d));
+    return true;
 }
 
-std::vector<std::tuple<std::string, std::string, float>> Consensus::deserializeVector(const std::unique_ptr<unsigned char[]>& data) {
-    size_t offset = sizeof(size_t);  // Start after total size
-    size_t numTuples;
-    std::memcpy(&numTuples, data.get() + offset, sizeof(numTuples));
-    offset += sizeof(numTuples);
-
-    std::vector<std::tuple<std::string, std::string, float>> vec;
-
-    auto extractString = [&](std::string& str) {
-        uint32_t length;
-        std::memcpy(&length, data.get() + offset, sizeof(length));
-        offset += sizeof(length);
-        str.assign(reinterpret_cast<const char*>(data.get() + offset), length);
-        offset += length;
-    };
-
-    for (size_t i = 0; i < numTuples; ++i) {
-        std::string str1, str2;
-        extractString(str1);
-        extractString(str2);
-
-        float value;
-        std::memcpy(&value, data.get() + offset, sizeof(value));
-        offset += sizeof(value);
+std::unique_ptr<unsigned char[]> Consensus::serializeVector(const std::vector<std::tuple<Address, std::string, float>>& vec) {
+    return VotesWire::encode(vec);
+}
 
-        vec.emplace_back(str1, str2, value);
+bool Consensus::deserializeVector(const std::unique_ptr<unsigned char[]>& data, std::vector<std::tuple<Address, std::string, float>>& vec) {
+    VotesWire::Decoded d;
+    if (!VotesWire::decode(data, d)) {
+        util::logCall("CONSENSUS", "deserializeVector()", false, "Malformed Votes");
+        return false;
     }
-
-    return vec;
+    vec = std::move(VotesWire::at<>(d));
+    return true;
 }
\ No newline at end of file
@@ -6,6 +6,35 @@
 #define CONSENSUS_H
 
 #include"util.h"
+#include "Interner.h"
+#include "Address.h"
+#include "Amount.h"
+#include "Serial.h"
+#include <unordered_set>
+#include <bit>
+
+/* Identity of a vote for de-duplication: voter, delegate, weight & voting epoch */
+struct VoteKey {
+    Address voter;
+    IdHandle delegate = Interner::NONE;
+    float weight = 0;
+    unsigned long long epoch = 0;
+
+    /* The weight compares by its bit pattern, as it is hashed */
+    bool operator==(const VoteKey& o) const {
+        return voter == o.voter && delegate == o.delegate && epoch == o.epoch
+            && std::bit_cast<uint32_t>(weight) == std::bit_cast<uint32_t>(o.weight);
+    }
+};
+
+struct VoteKeyHash {
+    size_t operator()(const VoteKey& k) const noexcept {
+        uint64_t h = AddressHash{}(k.voter) ^ (static_cast<uint64_t>(k.delegate) << 32);
+        h ^= (static_cast<uint64_t>(std::bit_cast<uint32_t>(k.weight)) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+        h ^= (k.epoch + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+        return static_cast<size_t>(h);
+    }
+};
 
 class Consensus {
 public:
@@ -19,18 +48,30 @@ public:
     std::vector<std::string> getDelegateIDs();
     void setDelegateIDs(const std::vector<std::string> &delIDs);
     void addDelegateID(const std::string& delegate_id);
-    std::vector<std::tuple<std::string, std::string, float>> getVotesQueue();
+    std::vector<std::tuple<Address, std::string, float>> getVotesQueue();
+    std::vector<std::tuple<Address, IdHandle, float>> getVotesQueueIDs();
+    size_t getVotesQueueSize();
 
     /* Request To become a delegate In the network */
-    std::tuple<bool, std::string> requestDelegate(double balance);
+    std::tuple<bool, std::string> requestDelegate(Amount balance);
     std::string genDelegateID();
 
     /* Get The Current Delegate Assigned to Block Creation */
     std::string getCurrentDelegate();
+    IdHandle getCurrentDelegateID();
     bool delIDExist(const std::string &ID) const;
+    bool delIDExist(IdHandle ID) const;
 
     /* Updated Votes From Network to Consensus */
-    void updatedVotes(const std::vector<std::tuple<std::string, std::string, float>>& votes);
+    void updatedVotes(const std::vector<std::tuple<Address, std::string, float>>& votes);
+    void updatedVotes(const std::vector<std::tuple<Address, IdHandle, float>>& votes);
+
+    /* Undo of a disconnected block: its votes leave the queue & the seen set, its new IDs are forgotten */
+    void revokeVotes(const std::vector<std::tuple<Address, IdHandle, float>>& votes);
+    void removeDelegateIDs(const std::vector<std::string>& ids);
+
+    /* Marks votes as seen for the current epoch, returns only the ones never seen before */
+    std::vector<std::tuple<Address, IdHandle, float>> filterNewVotes(const std::vector<std::tuple<Address, std::string, float>>& votes);
 
     /* Updated Delegate window based on votes in the network */
     void updateDelegates();
@@ -51,10 +92,10 @@ public:
 
     /* Serialization For Consensus information passed through network */
     std::unique_ptr<unsigned char[]> serializeConsensus();
-    std::tuple<unsigned long long, unsigned long long, unsigned long,
-    unsigned short, unsigned short, float, float> deserializeConsensus(const std::unique_ptr<unsigned char[]>& data);
-    static std::unique_ptr<unsigned char[]> serializeVector(const std::vector<std::tuple<std::string, std::string, float>>& vec);
-    static std::vector<std::tuple<std::string, std::string, float>> deserializeVector(const std::unique_ptr<unsigned char[]>& data);
+    bool deserializeConsensus(const std::unique_ptr<unsigned char[]>& data, std::tuple<unsigned long long, unsigned long long,
+        unsigned long, unsigned short, unsigned short, float, float>& out);
+    static std::unique_ptr<unsigned char[]> serializeVector(const std::vector<std::tuple<Address, std::string, float>>& vec);
+    static bool deserializeVector(const std::unique_ptr<unsigned char[]>& data, std::vector<std::tuple<Address, std::string, float>>& vec);
 
 private:
     /*
@@ -63,17 +104,24 @@ private:
      * U Short 1: window
      *
      * Votes Queue
-     * String 1: walled address
+     * Address 1: wallet address
      * String 2: delegate ID
      * Float 1: votes
      *
      * Delegates: queue of delegates to process blocks
-     * delegateID: list of known delegates
+     * delegateID: list of known delegates (knownIDs for O(1) lookups)
+     *
+     * Delegate IDs are held as Interner handles, strings are only
+     * produced for the network facing getters.
      */
 
-    std::vector<std::string> delegates;
-    std::vector<std::string> delegateID;
-    std::vector<std::tuple<std::string, std::string, float>> votesQueue;
+    std::vector<IdHandle> delegates;
+    std::vector<IdHandle> delegateID;
+    std::unordered_set<IdHandle> knownIDs;
+    std::vector<std::tuple<Address, IdHandle, float>> votesQueue;
+    std::unordered_set<VoteKey, VoteKeyHash> seenVotes;
+    unsigned long long seenEpoch;
+    std::mutex votesMutex;
     unsigned long long timestamp;
     unsigned long long lastUpd;
     unsigned long votingPeriod;
@@ -83,6 +131,13 @@ private:
     float decayFactor;
     float minBalance;
     static util u;
+
+    /* Wire layouts: consensus parameters in order; votes as count | (address, u32 length prefixed id, votes)... */
+    using Wire = serial::Layout<Consensus, serial::Field<&Consensus::timestamp>, serial::Field<&Consensus::lastUpd>,
+        serial::Field<&Consensus::votingPeriod>, serial::Field<&Consensus::windowPeriod>,
+        serial::Field<&Consensus::maxDelegates>, serial::Field<&Consensus::decayFactor>, serial::Field<&Consensus::minBalance>>;
+    using VotesWire = serial::Layout<std::vector<std::tuple<Address, std::string, float>>, serial::Count<>,
+        serial::FieldAs<serial::Seq<serial::Tuple<serial::Addr, serial::LenStr<uint32_t>, serial::Raw<float>>>>>;
 };
 
 
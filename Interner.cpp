@@ -0,0 +1,72 @@
+/*-- Interner.cpp ------------------------------------------------------------
+   This file implements the global identifier table.
+-----------------------------------------------------------------------------*/
+#include "Interner.h"
+
+std::shared_mutex Interner::mtx;
+std::deque<std::string> Interner::strings(1); // handle 0 == ""
+std::unordered_map<std::string_view, IdHandle> Interner::handles;
+
+IdHandle Interner::intern(const std::string_view id) {
+    if (id.empty()) {
+        return NONE;
+    }
+
+    /* Fast path, identifier already known */
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        if (const auto it = handles.find(id); it != handles.end()) {
+            return it->second;
+        }
+    }
+
+    /* Slow path, re-check under the exclusive lock then insert */
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    if (const auto it = handles.find(id); it != handles.end()) {
+        return it->second;
+    }
+
+    const auto h = static_cast<IdHandle>(strings.size());
+    const std::string& stored = strings.emplace_back(id);
+    handles.emplace(std::string_view(stored), h);
+    return h;
+}
+
+std::vector<IdHandle> Interner::intern(const std::vector<std::string>& ids) {
+    std::vector<IdHandle> out;
+    out.reserve(ids.size());
+    for (const auto& id : ids) {
+        out.push_back(intern(id));
+    }
+    return out;
+}
+
+IdHandle Interner::find(const std::string_view id) {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    const auto it = handles.find(id);
+    return it == handles.end() ? NONE : it->second;
+}
+
+const std::string& Interner::str(const IdHandle h) {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    if (h >= strings.size()) {
+        util::logCall("INTERNER", "str()", false, "Unknown handle");
+        return strings.front();
+    }
+    return strings[h];
+}
+
+std::vector<std::string> Interner::str(const std::vector<IdHandle>& hs) {
+    std::vector<std::string> out;
+    out.reserve(hs.size());
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    for (const IdHandle h : hs) {
+        out.emplace_back(h < strings.size() ? strings[h] : strings.front());
+    }
+    return out;
+}
+
+size_t Interner::size() {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return strings.size() - 1;
+}
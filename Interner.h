@@ -0,0 +1,58 @@
+#ifndef INTERNER
+#define INTERNER
+
+#include "util.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+/*-- Interner.h ---------------------------------------------------------------
+
+  This header file defines the global identifier table for this project.
+  Delegate IDs are mapped once to 32-bit handles so consensus structures
+  can store, hash and compare them as plain integers instead of copying
+  and comparing std::string. (Wallet addresses are fixed width binary,
+  see Address.h, and need no interning.)
+
+  Basic operations are:
+	 intern:  Returns the handle of a string, adding it if it is new
+	 find:    Returns the handle of a string or NONE if never interned
+	 str:     Returns the string a handle was created from
+
+Note:
+  Handles are local to this process and are NEVER sent over the network,
+  serialized forms keep using the strings themselves.
+  Handle 0 (NONE) is reserved for the empty string.
+-------------------------------------------------------------------------*/
+
+using IdHandle = uint32_t;
+
+class Interner
+{
+public:
+	static constexpr IdHandle NONE = 0;
+
+	/* Get (or create) the handle for an identifier */
+	static IdHandle intern(std::string_view id);
+	static std::vector<IdHandle> intern(const std::vector<std::string>& ids);
+
+	/* Lookup only, never grows the table */
+	static IdHandle find(std::string_view id);
+
+	/* Resolve handles back to identifiers */
+	static const std::string& str(IdHandle h);
+	static std::vector<std::string> str(const std::vector<IdHandle>& hs);
+
+	/* Number of identifiers known to the table */
+	static size_t size();
+
+private:
+	/* Strings are stored in a deque so references & views stay valid as it grows */
+	static std::shared_mutex mtx;
+	static std::deque<std::string> strings;
+	static std::unordered_map<std::string_view, IdHandle> handles;
+};
+
+#endif
@@ -0,0 +1,24 @@
+/*-- Inventory.cpp ------------------------------------------------------------
+   This file implements the per peer known-inventory filter.
+-----------------------------------------------------------------------------*/
+#include "Inventory.h"
+
+bool InvFilter::insert(const std::string& id) {
+    if (!ids.insert(id).second) {
+        return false;
+    }
+    order.push_back(id);
+    if (order.size() > capacity) {
+        ids.erase(order.front());
+        order.pop_front();
+    }
+    return true;
+}
+
+bool InvFilter::contains(const std::string& id) const {
+    return ids.contains(id);
+}
+
+size_t InvFilter::size() const {
+    return ids.size();
+}
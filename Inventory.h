@@ -0,0 +1,42 @@
+#ifndef INVENTORY
+#define INVENTORY
+
+#include "util.h"
+#include <deque>
+#include <unordered_set>
+
+/*-- Inventory.h --------------------------------------------------------------
+
+  This header file defines the known-inventory filter kept for every
+  connected peer. It remembers the txids a peer has announced, sent or
+  been told about, so a tx is announced at most once per link and never
+  echoed back to the peer it came from.
+
+  Basic operations are:
+	 insert:    Records an id, returns false if it was already known
+	 contains:  True if the id is known
+
+Note:
+  Memory is fixed: once capacity is reached the oldest id is forgotten,
+  which at worst costs one redundant announcement.
+  Inventory messages carry txids as 32 raw bytes, see Peer::serializeTxids.
+-------------------------------------------------------------------------*/
+
+class InvFilter
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 50000;
+
+	explicit InvFilter(size_t capacity = DEFAULT_CAPACITY) : capacity(capacity) {}
+
+	bool insert(const std::string& id);
+	bool contains(const std::string& id) const;
+	size_t size() const;
+
+private:
+	size_t capacity;
+	std::deque<std::string> order;
+	std::unordered_set<std::string> ids;
+};
+
+#endif
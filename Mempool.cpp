@@ -0,0 +1,180 @@
+/*-- Mempool.cpp --------------------------------------------------------------
+   This file implements the fee priority mempool member functions.
+-----------------------------------------------------------------------------*/
+#include "Mempool.h"
+
+Mempool::Mempool(const size_t maxBytes, RemoveHook onRemove)
+    : maxBytes(maxBytes), onRemove(std::move(onRemove))
+{
+}
+
+void Mempool::notify(const std::vector<std::string>& dropped) const {
+    if (!dropped.empty() && onRemove) {
+        onRemove(dropped);
+    }
+}
+
+bool Mempool::add(const transactions& tx, const utxout& uin) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::string& txid = tx.getTxid();
+    if (entries.contains(txid)) {
+        return false;
+    }
+
+    Amount spend = 0;
+    if (!tx.totalAmm(spend) || !Amounts::add(spend, tx.getFee(), spend)) {
+        util::logCall("MEMPOOL", "add()", false, "Amount Out Of Range");
+        return false;
+    }
+
+    const size_t size = tx.getSize();
+    if (size > maxBytes) {
+        util::logCall("MEMPOOL", "add()", false, "Tx Larger Than Mempool");
+        return false;
+    }
+
+    /* Find the lowest fee rate txs that must go, reject if any pays as well as tx */
+    const FeeKey probe{tx.getFee(), size, nextSeq, nullptr};
+    size_t freed = 0;
+    auto victim = byFeeRate.end();
+    while (totalBytes - freed + size > maxBytes) {
+        --victim;
+        if (!(probe < *victim)) {
+            util::logCall("MEMPOOL", "add()", false, "Mempool Full, Fee Rate Too Low");
+            return false;
+        }
+        freed += victim->size;
+    }
+
+    /* Evict */
+    std::vector<std::string> dropped;
+    while (freed > 0) {
+        const FeeKey& worst = *byFeeRate.rbegin();
+        freed -= worst.size;
+        eraseEntry(entries.find(*worst.txid), dropped);
+    }
+    notify(dropped);
+
+    /* Insert */
+    auto [it, inserted] = entries.try_emplace(txid, Entry{tx, uin, FeeKey{}, spend});
+    it->second.key = FeeKey{tx.getFee(), size, nextSeq++, &it->first};
+    byFeeRate.insert(it->second.key);
+    totalBytes += size;
+
+    Amount& senderPending = pending[tx.getSendAddr()];
+    if (!Amounts::add(senderPending, spend, senderPending)) {
+        senderPending = Amounts::MAX_MONEY;
+    }
+
+    util::logCall("MEMPOOL", "add()", true);
+    return true;
+}
+
+void Mempool::eraseEntry(const std::unordered_map<std::string, Entry>::iterator it, std::vector<std::string>& dropped) {
+    const Entry& e = it->second;
+    dropped.push_back(it->first);
+    byFeeRate.erase(e.key);
+    totalBytes -= e.key.size;
+
+    if (const auto p = pending.find(e.tx.getSendAddr()); p != pending.end()) {
+        p->second -= std::min(p->second, e.spend);
+        if (p->second == 0) pending.erase(p);
+    }
+    entries.erase(it);
+}
+
+bool Mempool::contains(const std::string& txid) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries.contains(txid);
+}
+
+bool Mempool::get(const std::string& txid, utxout& out) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto it = entries.find(txid);
+    if (it == entries.end()) {
+        return false;
+    }
+    out = it->second.uin;
+    return true;
+}
+
+bool Mempool::remove(const std::string& txid) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto it = entries.find(txid);
+    if (it == entries.end()) {
+        return false;
+    }
+    std::vector<std::string> dropped;
+    eraseEntry(it, dropped);
+    notify(dropped);
+    return true;
+}
+
+std::vector<utxout> Mempool::removeForBlock(const std::vector<transactions>& txs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<std::string> dropped;
+    std::vector<utxout> taken;
+    for (const auto& tx : txs) {
+        if (const auto it = entries.find(tx.getTxid()); it != entries.end()) {
+            taken.push_back(it->second.uin);
+            eraseEntry(it, dropped);
+        }
+    }
+    notify(dropped);
+    return taken;
+}
+
+std::vector<transactions> Mempool::select(const size_t budget) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<transactions> out;
+    size_t used = 0;
+    for (const FeeKey& key : byFeeRate) {
+        if (used + key.size > budget) {
+            break;
+        }
+        used += key.size;
+        out.push_back(entries.find(*key.txid)->second.tx);
+    }
+    return out;
+}
+
+std::vector<utxout> Mempool::snapshot() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<utxout> out;
+    out.reserve(entries.size());
+    for (const FeeKey& key : byFeeRate) {
+        out.push_back(entries.find(*key.txid)->second.uin);
+    }
+    return out;
+}
+
+Amount Mempool::pendingSpend(const Address& sender) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto it = pending.find(sender);
+    return it == pending.end() ? 0 : it->second;
+}
+
+size_t Mempool::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries.size();
+}
+
+size_t Mempool::bytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return totalBytes;
+}
+
+size_t Mempool::getMaxBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return maxBytes;
+}
+
+void Mempool::setMaxBytes(const size_t mb) {
+    std::lock_guard<std::mutex> lock(mtx);
+    maxBytes = mb;
+    std::vector<std::string> dropped;
+    while (totalBytes > maxBytes && !byFeeRate.empty()) {
+        eraseEntry(entries.find(*byFeeRate.rbegin()->txid), dropped);
+    }
+    notify(dropped);
+}
@@ -0,0 +1,116 @@
+#ifndef MEMPOOL
+#define MEMPOOL
+
+#include "util.h"
+#include "transactions.h"
+#include "Wallet.h"
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+/*-- Mempool.h ----------------------------------------------------------------
+
+  This header file defines the pool of verified transactions waiting for a
+  block. Transactions are indexed by txid and ordered by fee rate
+  (fee per serialized byte) so block producers take the best paying ones
+  first and a full pool drops the worst paying ones.
+
+  Basic operations are:
+	 add:             Inserts a verified tx, evicting lower fee rate txs
+	                  when the byte budget is exceeded
+	 remove:          Drops a tx by txid
+	 removeForBlock:  Drops every tx a newly linked block contains, returns
+	                  their signed form so a reorg can pool them again
+	 select:          Best fee rate txs fitting a byte budget
+	 pendingSpend:    Outputs + fees a sender has waiting in the pool
+
+Note:
+  Every operation is O(log n) in the pool size (per tx touched). All
+  members lock the pool, it is shared by the message & block threads.
+  onRemove hears, once per operation & under the pool lock, the txids
+  of every tx that left the pool (evicted, mined or removed).
+-------------------------------------------------------------------------*/
+
+class Mempool
+{
+public:
+	using RemoveHook = std::function<void(const std::vector<std::string>& txids)>;
+	static constexpr size_t DEFAULT_MAX_BYTES = 32000000;
+
+	explicit Mempool(size_t maxBytes = DEFAULT_MAX_BYTES, RemoveHook onRemove = {});
+
+	/* Add a tx with its signed relay form, false if already present, out of range or out-paid by a full pool */
+	bool add(const transactions& tx, const utxout& uin);
+
+	bool contains(const std::string& txid) const;
+
+	/* Signed relay form of a pool tx, false if not in the pool */
+	bool get(const std::string& txid, utxout& out) const;
+	bool remove(const std::string& txid);
+	std::vector<utxout> removeForBlock(const std::vector<transactions>& txs);
+
+	/* Highest fee rate first, stops once the next tx no longer fits budget */
+	std::vector<transactions> select(size_t budget) const;
+
+	/* Signed relay forms of every pool tx, highest fee rate first */
+	std::vector<utxout> snapshot() const;
+
+	/* Visits every pool tx under the pool lock, the visitor returns false to stop */
+	template <typename Visitor>
+	void visit(Visitor&& v) const {
+		std::lock_guard<std::mutex> lock(mtx);
+		for (const auto& [txid, e] : entries) {
+			if (!v(e.tx)) return;
+		}
+	}
+
+	/* Outputs + fees of pool txs sent by an address */
+	Amount pendingSpend(const Address& sender) const;
+
+	size_t size() const;
+	size_t bytes() const;
+	size_t getMaxBytes() const;
+	void setMaxBytes(size_t mb);
+
+private:
+	/* Priority key, ordered best fee rate first then oldest first */
+	struct FeeKey
+	{
+		Amount fee;
+		size_t size;
+		uint64_t seq;
+		const std::string* txid; // key of entries, node based so it stays valid
+
+		bool operator<(const FeeKey& other) const {
+			/* fee / size > other.fee / other.size without division */
+			const __int128 lhs = static_cast<__int128>(fee) * other.size;
+			const __int128 rhs = static_cast<__int128>(other.fee) * size;
+			if (lhs != rhs) return lhs > rhs;
+			return seq < other.seq;
+		}
+	};
+
+	struct Entry
+	{
+		transactions tx;
+		utxout uin;
+		FeeKey key;
+		Amount spend;
+	};
+
+	/* Callers hold mtx, the txid goes to dropped for onRemove */
+	void eraseEntry(std::unordered_map<std::string, Entry>::iterator it, std::vector<std::string>& dropped);
+	void notify(const std::vector<std::string>& dropped) const;
+
+	mutable std::mutex mtx;
+	std::unordered_map<std::string, Entry> entries;
+	std::set<FeeKey> byFeeRate;
+	std::unordered_map<Address, Amount, AddressHash> pending;
+	size_t totalBytes = 0;
+	size_t maxBytes;
+	uint64_t nextSeq = 0;
+	RemoveHook onRemove;
+};
+
+#endif
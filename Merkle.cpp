@@ -0,0 +1,73 @@
+/*-- Merkle.cpp ---------------------------------------------------------------
+   This file implements the incremental Merkle tree member functions.
+-----------------------------------------------------------------------------*/
+#include "Merkle.h"
+#include <bit>
+
+std::vector<unsigned char> MerkleBuilder::combine(const std::vector<unsigned char>& left, const std::vector<unsigned char>& right) {
+    std::string msg(left.begin(), left.end());
+    msg.append(right.begin(), right.end());
+    std::vector<unsigned char> hash;
+    if (!util::shaHash(msg, hash)) {
+        util::logCall("MERKLE", "combine()", false, "Hash Failed");
+        return {};
+    }
+    return hash;
+}
+
+void MerkleBuilder::append(const std::vector<unsigned char>& leaf) {
+    /* Carry up through every level that already has a left node */
+    std::vector<unsigned char> h = leaf;
+    size_t level = 0;
+    while (count & (uint64_t{1} << level)) {
+        h = combine(inner[level], h);
+        level++;
+    }
+    if (inner.size() <= level) {
+        inner.resize(level + 1);
+    }
+    inner[level] = std::move(h);
+    count++;
+}
+
+std::vector<unsigned char> MerkleBuilder::root() const {
+    if (count == 0) {
+        return {};
+    }
+
+    /* Lowest pending node, then close every level above it */
+    uint64_t c = count;
+    size_t level = std::countr_zero(c);
+    std::vector<unsigned char> h = inner[level];
+    while (c != (uint64_t{1} << level)) {
+        /* h has no right sibling, odd levels duplicate their last node */
+        h = combine(h, h);
+        c += uint64_t{1} << level;
+        level++;
+        while (!(c & (uint64_t{1} << level))) {
+            h = combine(inner[level], h);
+            level++;
+        }
+    }
+    return h;
+}
+
+size_t MerkleBuilder::size() const {
+    return count;
+}
+
+void MerkleBuilder::clear() {
+    inner.clear();
+    count = 0;
+}
+
+std::vector<unsigned char> MerkleBuilder::leaf(const transactions& tx) {
+    std::vector<unsigned char> out;
+    util::fromHex(tx.getTxid(), out);
+    return out;
+}
+
+std::vector<unsigned char> MerkleBuilder::blockRoot(const std::vector<unsigned char>& coinbaseLeaf,
+    const std::vector<unsigned char>& bodyRoot) {
+    return combine(coinbaseLeaf, bodyRoot);
+}
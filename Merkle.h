@@ -0,0 +1,44 @@
+#ifndef MERKLE
+#define MERKLE
+
+#include "util.h"
+#include "transactions.h"
+
+/*-- Merkle.h -----------------------------------------------------------------
+
+  This header file defines the incremental Merkle tree used for block
+  roots. Leaves are appended one at a time and only the left subtree
+  roots still waiting for a right sibling are kept (one per level), so
+  appending is O(log n) and the root can be read at any moment.
+
+  Basic operations are:
+	 append:     Adds a leaf
+	 root:       Root of the leaves so far, odd levels duplicate their
+	             last node; a single leaf is its own root
+	 leaf:       Leaf of a transaction, the raw bytes of its txid
+	 blockRoot:  Block Merkle root, H(coinbase leaf || root of the other
+	             txs), so a block template can grow without knowing its
+	             coinbase
+-------------------------------------------------------------------------*/
+
+class MerkleBuilder
+{
+public:
+	void append(const std::vector<unsigned char>& leaf);
+	std::vector<unsigned char> root() const;
+	size_t size() const;
+	void clear();
+
+	static std::vector<unsigned char> leaf(const transactions& tx);
+	static std::vector<unsigned char> blockRoot(const std::vector<unsigned char>& coinbaseLeaf,
+		const std::vector<unsigned char>& bodyRoot);
+
+private:
+	static std::vector<unsigned char> combine(const std::vector<unsigned char>& left, const std::vector<unsigned char>& right);
+
+	/* inner[level] is meaningful while bit 'level' of count is set */
+	std::vector<std::vector<unsigned char>> inner;
+	uint64_t count = 0;
+};
+
+#endif
@@ -8,6 +8,7 @@ void Peer::serverOnStart(Peer& server) {
     /* Setting initial Server Node */
     created = util::TimeStamp();
     sPeriod = 15;
+    blkTemplate.reset(X0017.getBlkSzLimit());
     chain = nullptr;
     rcvCns = false;
     servID initialNode;
@@ -23,6 +24,7 @@ void Peer::serverOnStart(Peer& server) {
             chain = new BlockChain();
             chain->initial();
             std::cout << "Chain Created!\n";
+            loadMempool();
 
             /* Prepare D-POS Consensus */
             consensus.setTimestamp(created);
@@ -37,8 +39,8 @@ void Peer::serverOnStart(Peer& server) {
                 }
             }
 
-            std::tuple<std::string, std::string, float> initialVote(w1.getWalletAddr(), delegateID, 0);
-            std::vector<std::tuple<std::string, std::string, float>> iv_Vector;
+            std::tuple<Address, std::string, float> initialVote(w1.getWalletAddr(), delegateID, 0);
+            std::vector<std::tuple<Address, std::string, float>> iv_Vector;
             iv_Vector.emplace_back(initialVote);
             vote(iv_Vector);
             consensus.updateDelegates();
@@ -95,19 +97,45 @@ void Peer::blkLoop(Peer& server) {
     util::logCall("NETWORK", "blkLoop()", true);
     while (true)
     {
-        if (!chain->empty()) {
-            /* Lock mutex for the update operation */
+        /* The sync timers run on the message thread, which owns the connection list & sync state */
+        if (const unsigned long long now = util::TimeStamp(); now != lastSyncTick) {
+            lastSyncTick = now;
+            olc::net::owned_message<CustomMsgTypes> tick;
+            tick.msg.header.id = CustomMsgTypes::SyncTick;
+            m_qMessagesIn.push_back(tick);
+        }
+
+        /* The periodic dump copies the pool under the lock & writes the file after releasing it */
+        std::optional<std::vector<utxout>> dumpPool;
+        {
+            /* Lock mutex for the update operation, the message thread links & reorgs under it too */
             std::lock_guard<std::mutex> lock(mtxB);
+            if (chain->empty()) {
+                continue;
+            }
             unsigned long long timestamp = util::TimeStamp();
 
+            if ((timestamp - lastMempoolDump) >= mempoolDumpPeriod) {
+                dumpPool = mempool.snapshot();
+                lastMempoolDump = timestamp;
+            }
+
+            if (timestamp != lastInvFlush) {
+                flushInventory();
+                lastInvFlush = timestamp;
+            }
+
             if ((timestamp - chain->getCurrBlock()->getTimestamp()) >= 15) {
-                currentDelegate = consensus.getCurrentDelegate();
-                if (currentDelegate == delegateID) {
+                currentDelegate = consensus.getCurrentDelegateID();
+                if (currentDelegate != Interner::NONE && currentDelegate == Interner::find(delegateID)) {
                     blkRqMethod();
                     train_data();
                 }
             }
         }
+        if (dumpPool) {
+            writeMempool(*dumpPool);
+        }
     }
 }
 
@@ -209,34 +237,75 @@ void Peer::updateSlot() {
 }
 
 void Peer::verifyMempool() {
-    std::vector<transactions> new_mempool;
-    for (auto& tx : mempool) {
-        if (chain->isNewTxid(tx.getTxid())) {
-            new_mempool.emplace_back(tx);
+    /* Removal by txid, only the txs of the new block are touched */
+    unpoolBlock(chain->getCurrBlock());
+    rebuildTemplate();
+}
+
+void Peer::unpoolBlock(const Block* b) {
+    /* The signed form is kept with the block's undo record, a reorg that takes the block off pools them again */
+    std::vector<utxout> taken = mempool.removeForBlock(b->getData());
+    if (!taken.empty()) {
+        std::ranges::move(taken, std::back_inserter(nodeUndo[b->getBlockHeight()].pooled));
+    }
+}
+
+void Peer::rebuildTemplate() {
+    /* Next template on the current tip, best paying first */
+    const size_t limit = X0017.getBlkSzLimit();
+    blkTemplate.reset(limit);
+    for (const auto& tx : mempool.select(limit)) {
+        blkTemplate.offer(tx);
+    }
+}
+
+bool Peer::mempool_emplace(const utxout& uin, const uint32_t fromPeer) {
+    std::optional<transactions> decoded;
+    if (!transactions::decode(std::span(reinterpret_cast<const uint8_t*>(uin.utxo.data()), uin.utxo.size()), decoded)) {
+        util::logCall("NETWORK", "mempool_emplace()", false, "Malformed Transaction");
+        return false;
+    }
+    const transactions& tx = *decoded;
+    {
+        /* The sender has it, whatever the outcome; a requested tx has arrived */
+        std::lock_guard<std::mutex> lock(mtxInv);
+        if (fromPeer != 0) {
+            peerKnown[fromPeer].insert(tx.getTxid());
         }
-        else {
-            continue;
+        if (const auto it = invRequested.find(tx.getTxid()); it != invRequested.end()) {
+            closeInvRequest(it);
         }
     }
-    mempool = std::move(new_mempool);
-    mempool.shrink_to_fit();
-}
 
-void Peer::mempool_emplace(const utxout& uin) {
-    transactions tx = transactions::deserialize(util::toUnsignedChar(uin.utxo));
+    bool accepted = false;
     /* Verify if the transaction is valid */
     if (tx.inputsValid() && tx.outputsValid()) {
-        /* check for double spend */
-        if (chain->isNewTxid(tx.getTxid())) {
-            if (w1.verifyTx(uin)) {
-                if (tx.getRecieveAddr().size() == tx.getAmmount().size()) {
-                    std::vector<std::string> txra = tx.getRecieveAddr();
-                    std::vector<double> txam = tx.getAmmount();
-                    std::vector<std::string> delegates = tx.getDelegates();
-                    std::vector<std::string> delegateID = tx.getDelegatesID();
-                    std::vector<std::tuple<std::string, std::string, float>> votesQueue = tx.getVotes();
-                    mempool.emplace_back(tx);
-                    verifyMempool();
+        /* check for double spend, identical content means identical txid */
+        if (!mempool.contains(tx.getTxid()) && chain->isNewTxid(tx.getTxid())) {
+            /* Signatures this node verified before (gossip echo, mempool reload) are not re-verified */
+            const std::vector<unsigned char> sigDigest = sigCache.digest(uin);
+            const bool sigOk = sigCache.contains(sigDigest) || w1.verifyTx(uin);
+            if (sigOk) {
+                sigCache.insert(sigDigest);
+                /* O(1) spend check against the chain's address balance index, less what the sender has pending */
+                Amount spend = 0;
+                const bool funded = tx.totalAmm(spend) && Amounts::add(spend, tx.getFee(), spend)
+                    && Amounts::add(spend, mempool.pendingSpend(tx.getSendAddr()), spend)
+                    && spend <= chain->spendableBalance(tx.getSendAddr());
+                if (!funded) {
+                    util::logCall("NETWORK", "mempool_emplace()", false, "Insufficient Balance");
+                    std::cout << "Insufficient Balance!\n";
+                }
+                else if (tx.getRecieveAddr().size() == tx.getAmmount().size()) {
+                    if (mempool.add(tx, uin)) {
+                        blkTemplate.offer(tx);
+                        std::lock_guard<std::mutex> lock(mtxInv);
+                        invQueue.push_back(tx.getTxid());
+                        accepted = true;
+                    }
+                    else {
+                        std::cout << "Transaction Not Accepted By Mempool!\n";
+                    }
                 }
                 else {
                     /* If the transaction Cant be verifies */
@@ -258,55 +327,718 @@ void Peer::mempool_emplace(const utxout& uin) {
         /* If the transaction inputs or outputs are invalid */
         std::cout << "Invalid transaction inputs or outputs!\n";
     }
+    return accepted;
+}
+
+bool Peer::isGossip(const CustomMsgTypes id) {
+    switch (id) {
+        case CustomMsgTypes::KnownNode:
+        case CustomMsgTypes::DelegateID:
+        case CustomMsgTypes::Votes:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Peer::firstSeen(const olc::net::message<CustomMsgTypes>& msg) {
+    RollingBloom::Digest d{};
+    if (!RollingBloom::digest(static_cast<uint32_t>(msg.header.id), msg.body.data(), msg.body.size(), d)) {
+        return true; // cannot tell, let the handler's own checks decide
+    }
+    return seenMsgs.insert(d);
+}
+
+void Peer::closeInvRequest(const std::unordered_map<std::string, InvRequest>::iterator it) {
+    if (const auto open = invOpen.find(it->second.peer); open != invOpen.end() && --open->second == 0) {
+        invOpen.erase(open);
+    }
+    invRequested.erase(it);
+}
+
+void Peer::flushInventory() {
+    std::lock_guard<std::mutex> lock(mtxInv);
+
+    /* Forget requests a peer never answered so another announcer can be asked */
+    const unsigned long long now = util::TimeStamp();
+    for (auto it = invRequested.begin(); it != invRequested.end();) {
+        if (now - it->second.at >= invRequestTimeout) {
+            closeInvRequest(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (invQueue.empty()) {
+        return;
+    }
+
+    /* Each peer is told about each txid once, minus the ones it sent or announced itself */
+    for (auto& conn : m_connections) {
+        if (!conn || !conn->IsConnected()) {
+            continue;
+        }
+        InvFilter& known = peerKnown[conn->GetID()];
+        std::vector<std::string> batch;
+        for (const auto& id : invQueue) {
+            if (!known.insert(id)) {
+                continue;
+            }
+            batch.push_back(id);
+            if (batch.size() == maxInvPerMsg) {
+                olc::net::message<CustomMsgTypes> inv;
+                inv.header.id = CustomMsgTypes::TxInv;
+                inv << serializeTxids(batch);
+                SendToPeer(conn, inv);
+                batch.clear();
+            }
+        }
+        if (!batch.empty()) {
+            olc::net::message<CustomMsgTypes> inv;
+            inv.header.id = CustomMsgTypes::TxInv;
+            inv << serializeTxids(batch);
+            SendToPeer(conn, inv);
+        }
+    }
+    invQueue.clear();
+    util::logCall("NETWORK", "flushInventory()", true);
+}
+
+bool Peer::dumpMempool(const std::string& path) {
+    return writeMempool(mempool.snapshot(), path);
+}
+
+bool Peer::writeMempool(const std::vector<utxout>& pool, const std::string& path) {
+    /*
+        Layout (native endian):
+            "DCMP" | uint32 version | uint64 count
+            count x ( serialize_utxout buffer (first size_t is its size) | 64 byte sigCache digest )
+    */
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        util::logCall("NETWORK", "writeMempool()", false, "Cannot Open Dump File");
+        return false;
+    }
+
+    /* A dump that did not make it to path leaves no partial tmp file behind */
+    auto fail = [&](const char* why) {
+        out.close();
+        std::remove(tmp.c_str());
+        util::logCall("NETWORK", "writeMempool()", false, why);
+        return false;
+    };
+
+    const uint32_t version = 1;
+    const uint64_t count = pool.size();
+    out.write("DCMP", 4);
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    for (const auto& uin : pool) {
+        const std::unique_ptr<unsigned char[]> buf = w1.serialize_utxout(uin);
+        size_t bufSize = 0;
+        std::memcpy(&bufSize, buf.get(), sizeof(size_t));
+        const std::vector<unsigned char> d = sigCache.digest(uin);
+        if (d.size() != SHA512_DIGEST_LENGTH) {
+            return fail("Digest Failed");
+        }
+        out.write(reinterpret_cast<const char*>(buf.get()), static_cast<std::streamsize>(bufSize));
+        out.write(reinterpret_cast<const char*>(d.data()), static_cast<std::streamsize>(d.size()));
+    }
+
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        return fail("Write Failed");
+    }
+    util::logCall("NETWORK", "writeMempool()", true);
+    return true;
+}
+
+size_t Peer::loadMempool(const std::string& path) {
+    if (mempoolLoaded) {
+        return 0;
+    }
+    mempoolLoaded = true;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return 0; // nothing dumped yet
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint64_t count = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, "DCMP", 4) != 0 || version != 1) {
+        util::logCall("NETWORK", "loadMempool()", false, "Invalid Dump Header");
+        return 0;
+    }
+
+    /* utxout header: tSize, txSize, shSize & key length */
+    constexpr size_t minEntry = sizeof(size_t) * 3 + sizeof(int);
+    constexpr size_t maxEntry = 4000000;
+    size_t loaded = 0, trusted = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        size_t bufSize = 0;
+        if (!in.read(reinterpret_cast<char*>(&bufSize), sizeof(size_t)) || bufSize < minEntry || bufSize > maxEntry) {
+            util::logCall("NETWORK", "loadMempool()", false, "Truncated Dump");
+            break;
+        }
+        std::unique_ptr<unsigned char[]> buf(new unsigned char[bufSize]);
+        std::memcpy(buf.get(), &bufSize, sizeof(size_t));
+        std::vector<unsigned char> stored(SHA512_DIGEST_LENGTH);
+        if (!in.read(reinterpret_cast<char*>(buf.get() + sizeof(size_t)), static_cast<std::streamsize>(bufSize - sizeof(size_t)))
+            || !in.read(reinterpret_cast<char*>(stored.data()), SHA512_DIGEST_LENGTH)) {
+            util::logCall("NETWORK", "loadMempool()", false, "Truncated Dump");
+            break;
+        }
+
+        /* Matching digest: this node verified the signature before, seed the cache */
+        utxout uin;
+        if (!w1.deserialize_utxout(buf, uin)) {
+            continue; // a damaged entry, the rest of the dump is still framed
+        }
+        if (sigCache.digest(uin) == stored) {
+            sigCache.insert(stored);
+            trusted++;
+        }
+
+        const size_t before = mempool.size();
+        mempool_emplace(uin);
+        loaded += mempool.size() - before;
+    }
+
+    std::cout << "Mempool reloaded: " << loaded << " txs (" << trusted << " from signature cache)\n";
+    util::logCall("NETWORK", "loadMempool()", true);
+    return loaded;
 }
 
 void Peer::blkRqMethod() {
     std::vector<transactions> txs;
 
     /* Reward For Miner */
-    std::vector<std::string> ra;
+    std::vector<Address> ra;
     std::vector<EVP_PKEY_ptr> rpk;
-    std::vector<double> amm;
+    std::vector<Amount> amm;
     std::vector<std::string> delegates = consensus.getDelegates();
     std::vector<std::string> delegateID = consensus.getDelegateIDs();
-    std::vector<std::tuple<std::string, std::string, float>> votesQueue = consensus.getVotesQueue();
+    std::vector<std::tuple<Address, std::string, float>> votesQueue = consensus.getVotesQueue();
     ra.push_back(w1.getWalletAddr());
     amm.push_back(X0017.getReward());
 
-    transactions reward(w1.getWalletAddr(), ra, amm, 0.0, w1.getLockTime(), w1.getVersion(), delegates,
+    transactions reward(w1.getWalletAddr(), ra, amm, 0, w1.getLockTime(), w1.getVersion(), delegates,
         delegateID, votesQueue);
-    txs.emplace_back(reward);
 
-    /* Add confirmed transactions To Block */
-    for (auto& tx : mempool) {
-        txs.emplace_back(tx);
+    /* The template already holds the selected txs & their Merkle tree, only the coinbase is added.
+       One that refused a tx for room may have left out a better paying one, it is selected again */
+    if (blkTemplate.stale()) {
+        rebuildTemplate();
     }
+    std::vector<unsigned char> merkleRoot;
+    blkTemplate.assemble(reward, txs, merkleRoot);
+    Block* blk = new Block(txs, std::move(merkleRoot), chain->getCurrBlock()->getCurrHash(), chain->getVersion(),
+        chain->getBlockHeight() + 1, util::TimeStamp(), nextCommitment());
 
     /* Generate Block And Add To Network */
-    chain->GenerateBlock(txs);
+    chain->GenerateBlock(txs, blk);
+    if (chain->getCurrBlock() != blk) {
+        util::logCall("NETWORK", "blkRqMethod()", false, "Block Cannot Be Verified");
+        delete blk;
+        return;
+    }
     updateCoins(reward); //************
+    if (Amount added = 0; reward.totalAmm(added)) {
+        nodeUndo[blk->getBlockHeight()].supplyAdded = added;
+    }
     verifyMempool();
     confirm();
     broadcastBlock(chain->getCurrBlock());
     util::logCall("NETWORK", "blkRqMethod()", true);
 }
 
-double Peer::getBalance() const {
+void Peer::linkBlock(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, Block* nb) {
+    if (nb == nullptr) {
+        util::logCall("NETWORK", "linkBlock()", false, "Block Cannot Be Decoded");
+        return;
+    }
+    if (!commitmentValid(nb)) {
+        delete nb;
+        return;
+    }
+
+    /* The block tree owns it from here, wherever it lands */
+    const unsigned int height = nb->getBlockHeight();
+    const std::vector<unsigned char> prevHash = nb->getPrevHash();
+    TipChange change;
+    if (!chain->submitBlock(nb, change)) {
+        util::logCall("NETWORK", "linkBlock()", false, "Block Cannot Be Verified");
+        delete nb;
+        return;
+    }
+    applyTipChange(change);
+    chain->dropStale();
+
+    /* Orphaned: a close parent is fetched from the announcer, a long gap is a sync */
+    if (change.connected.empty() && !chain->knowsBlock(prevHash, height - 1)) {
+        if (height <= chain->getBlockHeight() + maxOrphanGap) {
+            requestFullBlock(peer, height - 1);
+        }
+        else {
+            startSync(peer);
+        }
+    }
+    util::logCall("NETWORK", "linkBlock()", true);
+}
+
+void Peer::revertBlock(const unsigned int height) {
+    const auto it = nodeUndo.find(height);
+    if (it == nodeUndo.end()) {
+        return;
+    }
+    const NodeUndo& undo = it->second;
+    for (const OutPoint& out : undo.walletOutputs) {
+        if (!w1.revertUTXO(out)) {
+            util::logCall("NETWORK", "revertBlock()", false, "Reverted Output Already Spent");
+        }
+    }
+    if (undo.delegatesSet) {
+        consensus.setDelegates(undo.priorDelegates);
+    }
+    consensus.removeDelegateIDs(undo.addedDelegateIDs);
+    consensus.revokeVotes(undo.votes);
+
+    /* Coin setters add, so the reward comes back off as a negative amount */
+    X0017.setTotalSupply(-undo.supplyAdded);
+    X0017.setCircSupply(-undo.supplyAdded);
+    nodeUndo.erase(it);
+    util::logCall("NETWORK", "revertBlock()", true);
+}
+
+void Peer::applyTipChange(const TipChange& change) {
+    if (change.connected.empty()) {
+        return;
+    }
+
+    /* What the replaced blocks changed in this node goes first, newest first */
+    std::vector<utxout> repool;
+    for (const Block* b : change.disconnected) {
+        if (const auto it = nodeUndo.find(b->getBlockHeight()); it != nodeUndo.end()) {
+            std::ranges::move(it->second.pooled, std::back_inserter(repool));
+        }
+        revertBlock(b->getBlockHeight());
+    }
+    if (!change.disconnected.empty()) {
+        const unsigned int fork = change.disconnected.back()->getBlockHeight() - 1;
+        if (walletConfirmed != nullptr && walletConfirmed->getBlockHeight() > fork) {
+            walletConfirmed = chain->blockAt(fork);
+        }
+        if (fork < snapshotHeight) {
+            snapshotHeight = 0; // the state it captured was reverted
+            snapshotDigest.clear();
+        }
+        std::cout << "Reorg: " << change.disconnected.size() << " blocks replaced, tip now at height "
+                  << chain->getBlockHeight() << "\n";
+    }
+    for (const Block* b : change.connected) {
+        unpoolBlock(b);
+    }
+
+    /* Txs of the replaced blocks go back to the pool, unless the new branch has them or they are no longer funded.
+       Only those this node pooled before are known in signed form, blocks carry no signature */
+    for (const utxout& uin : repool) {
+        mempool_emplace(uin);
+    }
+    chain->setVersion(chain->getCurrBlock()->getVersion());
+    verifyMempool();
+    confirm();
+}
+
+void Peer::startSync(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer) {
+    if (chainSync.active()) {
+        return;
+    }
+    if (chain->empty()) {
+        chainSync.begin(0, {});
+    }
+    else {
+        chainSync.begin(chain->getBlockHeight() + 1, chain->getCurrBlock()->getCurrHash());
+    }
+    requestHeaders(peer, chainSync.nextHeaderHeight());
+    util::logCall("NETWORK", "startSync()", true);
+}
+
+/* A failed sync moves on to the connection after the one that failed, so every peer is tried once */
+void Peer::syncFromNext(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer) {
+    auto it = std::find(m_connections.begin(), m_connections.end(), peer);
+    if (it == m_connections.end()) {
+        return;
+    }
+    for (++it; it != m_connections.end(); ++it) {
+        if (*it && (*it)->IsConnected()) {
+            startSync(*it);
+            return;
+        }
+    }
+    util::logCall("NETWORK", "syncFromNext()", false, "No Peer Left To Sync From");
+}
+
+void Peer::requestHeaders(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, const unsigned int from) {
+    const size_t tSize = sizeof(size_t) + sizeof(unsigned int);
+    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
+    std::memcpy(buffer.get(), &tSize, sizeof(size_t));
+    std::memcpy(buffer.get() + sizeof(size_t), &from, sizeof(unsigned int));
+
+    olc::net::message<CustomMsgTypes> msg;
+    msg.header.id = CustomMsgTypes::GetHeaders;
+    msg << buffer;
+    SendToPeer(peer, msg);
+}
+
+void Peer::scheduleBodies() {
+    /* Every connected peer serves ranges, so download speed grows with the peer count */
+    const unsigned long long now = util::TimeStamp();
+    for (auto& conn : m_connections) {
+        if (!conn || !conn->IsConnected()) {
+            continue;
+        }
+        unsigned int from = 0, count = 0;
+        while (chainSync.nextRange(conn->GetID(), now, from, count)) {
+            ByteWriter w;
+            w.put(&from, sizeof(unsigned int));
+            w.put(&count, sizeof(unsigned int));
+
+            olc::net::message<CustomMsgTypes> msg;
+            msg.header.id = CustomMsgTypes::GetBlocks;
+            msg << w.finish();
+            SendToPeer(conn, msg);
+        }
+    }
+}
+
+void Peer::sendBlocks(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, const unsigned int from, const unsigned int count) {
+    /* Layout per frame: tSize | count | count x serialized block */
+    auto send = [&](ByteWriter& blocks, const size_t n) {
+        ByteWriter frame;
+        frame.body.reserve(sizeof(size_t) + blocks.body.size());
+        frame.put(&n, sizeof(size_t));
+        frame.put(blocks.body.data(), blocks.body.size());
+
+        olc::net::message<CustomMsgTypes> msg;
+        msg.header.id = CustomMsgTypes::Blocks;
+        msg << frame.finish();
+        SendToPeer(peer, msg);
+    };
+
+    ByteWriter blocks;
+    size_t n = 0;
+    for (unsigned int h = from; h - from < count; h++) {
+        const Block* b = chain->blockAt(h);
+        if (b == nullptr || b->isPruned()) {
+            break; // pruned bodies are left to archival peers, the range times out & moves on
+        }
+        const std::unique_ptr<unsigned char[]> buf = b->serialize();
+        size_t bSize = 0;
+        std::memcpy(&bSize, buf.get(), sizeof(size_t));
+        if (n > 0 && blocks.body.size() + bSize > maxFrameBytes) {
+            send(blocks, n);
+            blocks.body.clear();
+            n = 0;
+        }
+        blocks.put(buf.get(), bSize);
+        n++;
+    }
+    if (n > 0) {
+        send(blocks, n);
+    }
+    util::logCall("NETWORK", "sendBlocks()", true);
+}
+
+void Peer::applySynced() {
+    while (Block* nb = chainSync.popReady()) {
+        if (chain->empty() && pendingImport != nullptr) {
+            /* Fast sync: the verified snapshot stands in for every block below its anchor */
+            if (!chain->importState(*pendingImport, nb)) {
+                std::cout << "Chain sync aborted: snapshot anchor mismatch\n";
+                delete nb;
+                pendingImport.reset();
+                chainSync.finish();
+                return;
+            }
+            restoreSnapshot(*pendingImport);
+            pendingImport.reset();
+            std::cout << "State restored from snapshot at height " << nb->getBlockHeight() << "\n";
+        }
+        else if (chain->empty()) {
+            chain->initial(nb);
+            chain->setChnTmstmp(nb->getTimestamp());
+        }
+        else {
+            /* The header chain is already verified, the block carries the version it was made under */
+            chain->setVersion(nb->getVersion());
+            if (commitmentValid(nb)) {
+                chain->GenerateBlock(nb->getData(), nb);
+            }
+            if (chain->getCurrBlock() != nb) {
+                util::logCall("NETWORK", "applySynced()", false, "Block Cannot Be Verified");
+                std::cout << "Chain sync aborted at height " << nb->getBlockHeight() << "\n";
+                delete nb;
+                chainSync.finish();
+                return;
+            }
+        }
+        verifyMempool();
+        confirm();
+    }
+
+    if (chainSync.complete()) {
+        chainSync.finish();
+        std::cout << "Chain synced to height " << chain->getBlockHeight() << "\n";
+
+        /* Chain is current, restore the mempool dumped before the last shutdown */
+        loadMempool();
+        util::logCall("NETWORK", "applySynced()", true);
+    }
+}
+
+/* Pipeline sink, runs on its apply thread: a body that passed every check is queued for the message thread */
+void Peer::syncedBlock(Block* nb) {
+    {
+        std::lock_guard<std::mutex> lock(mtxSync);
+        syncedBlocks.push_back(nb);
+    }
+    olc::net::owned_message<CustomMsgTypes> wake;
+    wake.msg.header.id = CustomMsgTypes::SyncedBlocks;
+    m_qMessagesIn.push_back(wake);
+}
+
+/* Message thread: queued bodies go into the reorder window, then are applied if they are next */
+void Peer::drainSynced() {
+    std::deque<Block*> ready;
+    {
+        std::lock_guard<std::mutex> lock(mtxSync);
+        ready.swap(syncedBlocks);
+    }
+    if (ready.empty()) {
+        return;
+    }
+    for (Block* nb : ready) {
+        if (!chainSync.accept(nb)) {
+            delete nb;
+        }
+    }
+    applySynced();
+    scheduleBodies();
+}
+
+std::string Peer::snapshotPath(const unsigned int height) {
+    return "snapshot-" + std::to_string(height) + ".dat";
+}
+
+void Peer::takeSnapshot() {
+    Block* lc = chain->getLastConfirmed();
+    if (lc == nullptr) {
+        return;
+    }
+    /* The latest snapshot height confirmed, taken at that exact height even when one confirm crossed it */
+    const unsigned int h = lc->getBlockHeight() - lc->getBlockHeight() % Snapshot::INTERVAL;
+    if (h == 0 || h == snapshotHeight) {
+        return;
+    }
+
+    Snapshot snap;
+    if (!chain->exportState(snap, h)) {
+        return;
+    }
+    snapshotHeight = h;
+    snapshotDigest = snap.digest();
+
+    /* The current & previous snapshot are kept, a joining node may still be after the older one */
+    if (snap.save(snapshotPath(h)) && h > 2 * Snapshot::INTERVAL) {
+        std::remove(snapshotPath(h - 2 * Snapshot::INTERVAL).c_str());
+    }
+    util::logCall("NETWORK", "takeSnapshot()", true);
+}
+
+std::vector<unsigned char> Peer::nextCommitment() {
+    /* Only the first block after the snapshot height reached conf depth commits to it */
+    if (snapshotHeight == 0 || chain->getBlockHeight() != snapshotHeight + chain->getConf()) {
+        return {};
+    }
+    return snapshotDigest;
+}
+
+bool Peer::commitmentValid(const Block* nb) {
+    const std::vector<unsigned char> digest = nb->getSnapshotDigest();
+    if (digest.empty()) {
+        return true;
+    }
+    /* Checked against the block's own height, so a side branch block is held to the same rule */
+    const unsigned int conf = chain->getConf();
+    const unsigned int h = nb->getBlockHeight();
+    bool valid = h > conf + 1u && (h - conf - 1u) % Snapshot::INTERVAL == 0;
+
+    /* Any other height than the snapshot held (a reorg reverted it) is rebuilt from the undo records,
+       a commitment to a state this node cannot rebuild is refused, never trusted */
+    if (valid && h - conf - 1u == snapshotHeight) {
+        valid = digest == snapshotDigest;
+    }
+    else if (valid) {
+        Snapshot snap;
+        valid = chain->exportState(snap, h - conf - 1u) && digest == snap.digest();
+    }
+    if (!valid) {
+        util::logCall("NETWORK", "commitmentValid()", false, "Snapshot Commitment Mismatch");
+        std::cout << "Block rejected: snapshot commitment mismatch\n";
+        return false;
+    }
+    return true;
+}
+
+bool Peer::requestSnapshot(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer) {
+    unsigned int commitHeight = 0;
+    std::vector<unsigned char> digest;
+    if (!fastSync || !chain->empty() || !chainSync.latestCommitment(commitHeight, digest)) {
+        return false;
+    }
+
+    /* The commitment sits in the first block after the snapshot height reached conf depth */
+    const unsigned int conf = chain->getConf();
+    if (commitHeight <= conf + 1u) {
+        return false;
+    }
+    wantedSnapshot = commitHeight - 1 - conf;
+    wantedDigest = std::move(digest);
+    snapshotRequested = util::TimeStamp();
+
+    ByteWriter w;
+    w.put(&wantedSnapshot, sizeof(unsigned int));
+    olc::net::message<CustomMsgTypes> msg;
+    msg.header.id = CustomMsgTypes::GetSnapshot;
+    msg << w.finish();
+    SendToPeer(peer, msg);
+    std::cout << "Requesting state snapshot at height " << wantedSnapshot << "\n";
+    util::logCall("NETWORK", "requestSnapshot()", true);
+    return true;
+}
+
+bool Peer::acceptSnapshot(std::unique_ptr<Snapshot> snap) {
+    /* Trusted only if it is the state the header chain commits to, anchored on the header chain */
+    std::vector<unsigned char> anchor;
+    if (snap->height != wantedSnapshot || snap->digest() != wantedDigest
+        || !chainSync.hashAt(snap->height, anchor) || anchor != snap->anchor) {
+        util::logCall("NETWORK", "acceptSnapshot()", false, "Snapshot Not Committed");
+        return false;
+    }
+    if (!chainSync.skipTo(snap->height)) {
+        return false;
+    }
+    pendingImport = std::move(snap);
+    util::logCall("NETWORK", "acceptSnapshot()", true);
+    return true;
+}
+
+void Peer::restoreSnapshot(const Snapshot& snap) {
+    snapshotHeight = snap.height;
+    snapshotDigest = snap.digest();
+    walletConfirmed = chain->getFirstBlock(); // the anchor's outputs are in the snapshot balance
+
+    /* Only the committed section is trusted: supply is what coinbases minted (a fresh node starts from
+       zero, so the setters' additions set it), delegates & votes are left to gossip & confirmed blocks */
+    X0017.setTotalSupply(snap.minted);
+    X0017.setCircSupply(snap.minted);
+    w1.seedUTXO(snap.height, chain->verifyBalance(w1.getWalletAddr()));
+
+    /* Served on to later joiners, without the sending peer's uncommitted section */
+    Snapshot committed = snap;
+    committed.totalSupply = 0;
+    committed.circSupply = 0;
+    committed.delegates.clear();
+    committed.delegateIDs.clear();
+    committed.votes.clear();
+    committed.save(snapshotPath(snap.height));
+    util::logCall("NETWORK", "restoreSnapshot()", true);
+}
+
+bool Peer::readHeight(const std::unique_ptr<unsigned char[]>& buffer, unsigned int& height) {
+    if (!buffer) {
+        return false;
+    }
+    size_t tSize = 0;
+    std::memcpy(&tSize, buffer.get(), sizeof(size_t));
+    if (tSize != sizeof(size_t) + sizeof(unsigned int)) {
+        return false;
+    }
+    std::memcpy(&height, buffer.get() + sizeof(size_t), sizeof(unsigned int));
+    return true;
+}
+
+void Peer::completeCompact(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, const PartialBlock& pb) {
+    Block* nb = pb.build();
+    if (nb == nullptr) {
+        requestFullBlock(peer, pb.getCompact().height);
+        return;
+    }
+    if (chain->verifyBlockchain()) {
+        linkBlock(peer, nb);
+    }
+    else {
+        delete nb;
+    }
+}
+
+void Peer::requestFullBlock(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, const unsigned int height) {
+    const size_t tSize = sizeof(size_t) + sizeof(unsigned int);
+    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
+    std::memcpy(buffer.get(), &tSize, sizeof(size_t));
+    std::memcpy(buffer.get() + sizeof(size_t), &height, sizeof(unsigned int));
+
+    olc::net::message<CustomMsgTypes> msg;
+    msg.header.id = CustomMsgTypes::GetBlk;
+    msg << buffer;
+    SendToPeer(peer, msg);
+    util::logCall("NETWORK", "requestFullBlock()", true);
+}
+
+Amount Peer::getBalance() const {
+    std::lock_guard<std::mutex> lock(mtxB);
     return w1.getBalance();
 }
 
-std::string Peer::getWalletAddress() const {
+Amount Peer::getAddressBalance(const Address& wa) const {
+    std::lock_guard<std::mutex> lock(mtxB);
+    return chain->verifyBalance(wa);
+}
+
+Address Peer::getWalletAddress() const {
     return w1.getWalletAddr();
 }
 
 void Peer::listTx() {
+    std::lock_guard<std::mutex> lock(mtxB);
     w1.listTxs();
 }
 
-bool Peer::sendTx(std::vector<std::string>& recipients, std::vector<double> amounts) {
+void Peer::txHistory(const size_t page) {
+    std::lock_guard<std::mutex> lock(mtxB);
+    constexpr size_t pageSize = 10;
+    const Address& self = w1.getWalletAddr();
+    const size_t total = chain->getHistorySize(self);
+    std::cout << "Chain history page " << page << " (" << total << " transactions)\n";
+    for (auto& tx : chain->getHistoryTxs(self, page, pageSize)) {
+        tx.display();
+    }
+}
+
+bool Peer::sendTx(std::vector<Address>& recipients, std::vector<Amount> amounts) {
+    /* The wallet picks coins confirm() & revertBlock() may be changing */
+    std::lock_guard<std::mutex> lock(mtxB);
     std::vector<std::string> delegates;
     std::vector<std::string> delegateID;
-    std::vector<std::tuple<std::string, std::string, float>> votesQueue;
+    std::vector<std::tuple<Address, std::string, float>> votesQueue;
     utxout u1 = w1.outUTXO(X0017.getTxFee(), recipients, amounts, delegates, delegateID, votesQueue);
     mempool_emplace(u1);
 
@@ -314,15 +1046,39 @@ bool Peer::sendTx(std::vector<std::string>& recipients, std::vector<double> amou
     return true;
 }
 
+bool Peer::setCoinSelection(const std::string& strategy) {
+    std::unique_ptr<CoinSelector> cs = CoinSelector::create(strategy);
+    if (!cs) {
+        util::logCall("NETWORK", "setCoinSelection()", false, "Unknown Strategy");
+        return false;
+    }
+    w1.setCoinSelector(std::move(cs));
+    util::logCall("NETWORK", "setCoinSelection()", true);
+    return true;
+}
+
+bool Peer::setPruning(const unsigned int keep) {
+    /* Blocks below the depth lose their bodies, so they are no longer served to syncing peers */
+    std::lock_guard<std::mutex> lock(mtxB);
+    if (!chain->setPruneDepth(keep)) {
+        return false;
+    }
+    chain->pruneBodies(walletConfirmed);
+    return true;
+}
+
 void Peer::getKnownTx(std::string& txid) {
+    std::lock_guard<std::mutex> lock(mtxB);
     chain->getTx(txid).display();
 }
 
 void Peer::currBlockInfo() {
+    std::lock_guard<std::mutex> lock(mtxB);
     chain->display();
 }
 
 void Peer::getBlock(unsigned int height) {
+    std::lock_guard<std::mutex> lock(mtxB);
     chain->getBlock(height);
 }
 
@@ -330,16 +1086,15 @@ std::string Peer::get_this_delID() const {
     return delegateID;
 }
 
-void Peer::set_address(const std::string& wa) {
+void Peer::set_address(const Address& wa) {
     w1.setWalletAddr(wa);
 }
 
 void Peer::updateCoins(transactions rew) {
-    double totus = 0;
-    std::vector<double> amm = rew.getAmmount();
-
-    for (double am : amm) {
-        totus += am;
+    Amount totus = 0;
+    if (!rew.totalAmm(totus)) {
+        util::logCall("NETWORK", "updateCoins()", false, "Reward Out Of Range");
+        return;
     }
 
     X0017.setTotalSupply(totus);
@@ -349,27 +1104,29 @@ void Peer::updateCoins(transactions rew) {
 void Peer::confirm() {
     /* Get latest Confirmed Block */
     Block* confirmed = chain->confirmation();
+    if (confirmed == nullptr) {
+        return;
+    }
 
-    if (confirmed != nullptr) {
-        if (!confirmed->getTxs().empty()) {
+    /* Every block that reached conf depth since the last call, a reorg onto a longer branch can confirm several */
+    Block* next = (walletConfirmed == nullptr) ? chain->getFirstBlock() : walletConfirmed->next;
+    while (next != nullptr && next->getBlockHeight() <= confirmed->getBlockHeight()) {
+        NodeUndo& undo = nodeUndo[next->getBlockHeight()];
+        if (!next->getTxs().empty()) {
             std::vector<transactions> txs;
-            txs = confirmed->getTxs();
+            txs = next->getTxs();
 
             for (auto& tx : txs) {
-                const size_t recSize = tx.getRecieveAddr().size();
-                std::vector<std::string> rec;
-                rec = tx.getRecieveAddr();
+                const std::vector<Address>& rec = tx.getRecieveAddr();
 
-                if (recSize > 0) {
+                if (!rec.empty()) {
                     /* Update Wallet */
-                    size_t pos = 0;
-                    for (auto& ra : rec) {
-                        if (w1.getWalletAddr() == ra) {
-                            w1.inUTXO(tx, pos);
+                    const Address& self = w1.getWalletAddr();
+                    for (size_t pos = 0; pos < rec.size(); pos++) {
+                        if (rec[pos] == self && w1.inUTXO(tx, pos)) {
+                            undo.walletOutputs.push_back(OutPoint{tx.getTxid(), static_cast<uint32_t>(pos)});
                         }
-                        pos++;
                     }
-                    rec.clear();
                 }
 
                 /* Update Consensus */
@@ -378,34 +1135,70 @@ void Peer::confirm() {
                 size_t votesSize = tx.getVotes().size();
                 std::vector<std::string> delegates;
                 std::vector<std::string> delegateID;
-                std::vector<std::tuple<std::string, std::string, float>> votesQueue;
+                std::vector<std::tuple<Address, std::string, float>> votesQueue;
 
                 if (delSize > 0) {
                     delegates = tx.getDelegates();
+                    if (!undo.delegatesSet) {
+                        undo.delegatesSet = true;
+                        undo.priorDelegates = consensus.getDelegates();
+                    }
                     consensus.setDelegates(delegates);
                     delegates.clear();
                 }
 
                 if (delIDSize > 0) {
                     delegateID = tx.getDelegatesID();
+                    for (const auto& id : delegateID) {
+                        if (!consensus.delIDExist(id) && std::ranges::find(undo.addedDelegateIDs, id) == undo.addedDelegateIDs.end()) {
+                            undo.addedDelegateIDs.push_back(id);
+                        }
+                    }
                     consensus.setDelegateIDs(delegateID);
                     delegateID.clear();
                 }
 
                 if (votesSize > 0) {
+                    /* Votes already gossiped are not applied a second time */
                     votesQueue = tx.getVotes();
-                    consensus.updatedVotes(votesQueue);
+                    std::vector<std::tuple<Address, IdHandle, float>> fresh = consensus.filterNewVotes(votesQueue);
+                    undo.votes.insert(undo.votes.end(), fresh.begin(), fresh.end());
+                    consensus.updatedVotes(fresh);
                     votesQueue.clear();
                 }
             }
         }
+        walletConfirmed = next;
+        next = next->next;
     }
+
+    /* Records deeper than the chain can still disconnect are of no further use */
+    while (!nodeUndo.empty() && nodeUndo.begin()->first + BlockChain::UNDO_DEPTH <= confirmed->getBlockHeight()) {
+        nodeUndo.erase(nodeUndo.begin());
+    }
+    takeSnapshot();
+
+    /* Bodies go only once the walk above has read them */
+    chain->pruneBodies(walletConfirmed);
 }
 
 /* Vote For Delegates */
-void Peer::vote(std::vector<std::tuple<std::string, std::string, float>> votes) {
-    consensus.updatedVotes(votes);
-    broadcastVotes(votes);
+void Peer::vote(std::vector<std::tuple<Address, std::string, float>> votes) {
+    /* Only votes not yet seen are applied & relayed */
+    std::vector<std::tuple<Address, IdHandle, float>> fresh = consensus.filterNewVotes(votes);
+    if (!fresh.empty()) {
+        consensus.updatedVotes(fresh);
+        broadcastVotes(toVoteStrings(fresh));
+    }
+}
+
+std::vector<std::tuple<Address, std::string, float>> Peer::toVoteStrings(const std::vector<std::tuple<Address, IdHandle, float>>& votes) {
+    std::vector<std::tuple<Address, std::string, float>> out;
+    out.reserve(votes.size());
+    for (const auto& [voter, del, weight] : votes) {
+        out.emplace_back(voter, Interner::str(del), weight);
+    }
+    return out;
 }
 
 std::string Peer::requestDelegate(){
@@ -430,10 +1223,10 @@ bool Peer::ConnectTo(const std::string& host, uint16_t port) {
 void Peer::train_data() {
     /*Prepare data for load */
     std::vector<double> data;
-    const double totalSupply = X0017.getTotalSupply();
-    const double circSupply = X0017.getCircSupply();
-    const double balance = w1.getBalance();
-    const double periodVotes = static_cast<double>(consensus.getVotesQueue().size());
+    const double totalSupply = Amounts::toCoins(X0017.getTotalSupply());
+    const double circSupply = Amounts::toCoins(X0017.getCircSupply());
+    const double balance = Amounts::toCoins(w1.getBalance());
+    const double periodVotes = static_cast<double>(consensus.getVotesQueueSize());
     const double height = chain->getBlockHeight();
     const double txVolume = static_cast<double>(chain->getCurrBlock()->getData().size());
 
@@ -466,14 +1259,7 @@ void Peer::BroadcastChat(const std::string& text) {
     msg.header.id = CustomMsgTypes::ChatMessage;
 
     // Use the overloaded operator<< to serialize the text into the message.
-    size_t offset = 0;
-    size_t datasize = text.size() * sizeof(char);
-    size_t tSize = sizeof(size_t) + sizeof(size_t) + datasize;
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(size_t)); offset += sizeof(size_t);
-    std::memcpy(buffer.get() + offset, &datasize, sizeof(size_t)); offset += sizeof(size_t);
-    std::memcpy(buffer.get() + offset, text.data(), datasize);
-    msg << buffer;
+    msg << TextWire::encode(text);
 
     // Broadcast the message using the base class function.
     util::logCall("NETWORK", "BroadcastChat()", true);
@@ -483,6 +1269,7 @@ void Peer::broadcastNode(std::unique_ptr<unsigned char[]> sid) {
     olc::net::message<CustomMsgTypes> msg;
     msg.header.id = CustomMsgTypes::KnownNode;
     msg << sid;
+    firstSeen(msg);
 
     // Broadcast the message using the base class function.
     util::logCall("NETWORK", "broadcastNode()", true);
@@ -490,47 +1277,41 @@ void Peer::broadcastNode(std::unique_ptr<unsigned char[]> sid) {
 }
 
 void Peer::broadcastBlock(const Block* block) {
+    /* Head + short IDs, peers rebuild the body from their mempools */
+    uint64_t nonce = 0;
+    RAND_bytes(reinterpret_cast<unsigned char*>(&nonce), sizeof(nonce));
+    CompactBlock cb;
     olc::net::message<CustomMsgTypes> msg;
-    msg.header.id = CustomMsgTypes::BlkRecieved;
-    msg << block->serialize();
+    if (CompactBlock::fromBlock(block, nonce, cb)) {
+        msg.header.id = CustomMsgTypes::CmpctBlock;
+        msg << cb.serialize();
+    }
+    else {
+        msg.header.id = CustomMsgTypes::BlkRecieved;
+        msg << block->serialize();
+    }
 
     // Broadcast the message using the base class function.
     util::logCall("NETWORK", "broadcastBlock()", true);
     this->Broadcast(msg);
 }
 
-void Peer::broadcastTransaction(const utxout& u_out) {
-    olc::net::message<CustomMsgTypes> msg;
-    msg.header.id = CustomMsgTypes::TxRecieved;
-    msg << w1.serialize_utxout(u_out);
-
-    // Broadcast the message using the base class function.
-    util::logCall("NETWORK", "broadcastTransaction()", true);
-    this->Broadcast(msg);
-}
-
 void Peer::broadcastDelegateID(const std::string& id) {
     olc::net::message<CustomMsgTypes> msg;
     msg.header.id = CustomMsgTypes::DelegateID;
-
-    size_t offset = 0;
-    size_t datasize = id.size() * sizeof(char);
-    size_t tSize = sizeof(size_t) + sizeof(size_t) + datasize;
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(size_t)); offset += sizeof(size_t);
-    std::memcpy(buffer.get() + offset, &datasize, sizeof(size_t)); offset += sizeof(size_t);
-    std::memcpy(buffer.get() + offset, id.data(), datasize);
-    msg << buffer;
+    msg << TextWire::encode(id);
+    firstSeen(msg);
 
     // Broadcast the message using the base class function.
     util::logCall("NETWORK", "broadcastDelegateID()", true);
     this->Broadcast(msg);
 }
 
-void Peer::broadcastVotes(std::vector<std::tuple<std::string, std::string, float>> votes) {
+void Peer::broadcastVotes(std::vector<std::tuple<Address, std::string, float>> votes) {
     olc::net::message<CustomMsgTypes> msg;
     msg.header.id = CustomMsgTypes::Votes;
     msg << Consensus::serializeVector(votes);
+    firstSeen(msg);
 
     // Broadcast the message using the base class function.
     util::logCall("NETWORK", "broadcastVotes()", true);
@@ -538,137 +1319,89 @@ void Peer::broadcastVotes(std::vector<std::tuple<std::string, std::string, float
 }
 
 std::unique_ptr<unsigned char[]> Peer::serializeStruct(const servID& sid) {
-    size_t hostSize = sid.host.size() + 1;  // include null terminator
-    size_t outSize = sizeof(size_t) + sizeof(size_t) + sizeof(uint16_t) + hostSize;
-
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[outSize]);
-    size_t offset = 0;
-
-    // Copy hostSize
-    std::memcpy(buffer.get() + offset, &outSize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    // Copy hostSize
-    std::memcpy(buffer.get() + offset, &hostSize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    // Copy port number
-    std::memcpy(buffer.get() + offset, &sid.portNum, sizeof(uint16_t));
-    offset += sizeof(uint16_t);
-
-    // Copy host string
-    std::memcpy(buffer.get() + offset, sid.host.c_str(), hostSize);
-
-    return buffer;
+    return ServIDWire::encode(sid);
 }
 
-servID Peer::deserializeStruct(const std::unique_ptr<unsigned char[]>& buffer) {
-    servID sid;
-    size_t tSize = 0;
-    size_t hostSize = 0;
-    size_t offset = 0;
-
-    std::memcpy(&tSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    std::memcpy(&hostSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    std::memcpy(&sid.portNum, buffer.get() + offset, sizeof(uint16_t));
-    offset += sizeof(uint16_t);
-
-    sid.host = std::string(reinterpret_cast<const char*>(buffer.get() + offset), hostSize - 1);  // exclude null terminator
+bool Peer::deserializeStruct(const std::unique_ptr<unsigned char[]>& buffer, servID& sid) {
+    ServIDWire::Decoded d;
+    if (!ServIDWire::decode(buffer, d)) {
+        util::logCall("NETWORK", "deserializeStruct()", false, "Malformed servID");
+        return false;
+    }
+    sid.host = std::move(ServIDWire::at<&servID::host>(d));
+    sid.portNum = ServIDWire::at<&servID::portNum>(d);
+    return true;
+}
 
-    return sid;
+bool Peer::deserializeText(const std::unique_ptr<unsigned char[]>& buffer, std::string& text) {
+    TextWire::Decoded d;
+    if (!TextWire::decode(buffer, d)) {
+        util::logCall("NETWORK", "deserializeText()", false, "Malformed Text");
+        return false;
+    }
+    text = std::move(TextWire::at<>(d));
+    return true;
 }
 
 /* Serialization Methods */
-// serialize
 std::unique_ptr<unsigned char[]> Peer::serializeWalletInfo(const walletInfo& info) {
+    return WalletInfoWire::encode(info);
+}
 
-    /* Calculate the size required for serialization: */
-    size_t tSize = 0;
-
-    // Size of clientID (uint32_t), walladdr length (size_t), walladdr content, and public key length */
-    size_t addrSize = info.walladdr.size() + 1;
-    size_t pubKeySize = (info.pubKeyy != nullptr) ? i2d_PUBKEY(info.pubKeyy.get(), nullptr) : 0;
-    tSize += sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(uint32_t) + addrSize + pubKeySize;
+/* Deserialize Wallet info */
+bool Peer::deserializeWalletInfo(const std::unique_ptr<unsigned char[]>& buffer, walletInfo& info) {
+    WalletInfoWire::Decoded d;
+    if (!WalletInfoWire::decode(buffer, d)) {
+        util::logCall("NETWORK", "deserializeWalletInfo()", false, "Malformed walletInfo");
+        return false;
+    }
+    info.clientID = WalletInfoWire::at<&walletInfo::clientID>(d);
+    info.walladdr = WalletInfoWire::at<&walletInfo::walladdr>(d);
+    info.pubKeyy = std::move(WalletInfoWire::at<&walletInfo::pubKeyy>(d));
+    return true;
+}
 
-    /* Allocate buffer for serialization */
+std::unique_ptr<unsigned char[]> Peer::serializeTxids(const std::vector<std::string>& txids) {
+    /* Layout: tSize | count | count x 32 raw txid bytes */
+    constexpr size_t idSize = 32;
+    const size_t count = txids.size();
+    const size_t tSize = sizeof(size_t) + sizeof(size_t) + count * idSize;
     std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    size_t offset = 0;
-
-    /* serialize utx-out */
-
-    /* Serialize tSize itself */
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(tSize));
-    offset += sizeof(tSize);
-
-    /* Serialize addrSize Size itself */
-    std::memcpy(buffer.get() + offset, &addrSize, sizeof(size_t));
-    offset += sizeof(size_t);
 
-    /* Serialize pubKeySize Size itself */
-    std::memcpy(buffer.get() + offset, &pubKeySize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Serialize clientID itself */
-    std::memcpy(buffer.get() + offset, &info.clientID, sizeof(uint32_t));
-    offset += sizeof(uint32_t);
-
-    /* Serialize WallAddress itself */
-    std::memcpy(buffer.get() + offset, info.walladdr.c_str(), addrSize);
-    offset += addrSize;
-
-    /* Serialize pubKeyy (EVP_PKEY*) */
-    if (info.pubKeyy != nullptr) {
-        unsigned char* tempPtr = buffer.get() + offset;
-        i2d_PUBKEY(info.pubKeyy.get(), &tempPtr);
-        offset += pubKeySize;
+    size_t offset = 0;
+    std::memcpy(buffer.get() + offset, &tSize, sizeof(size_t)); offset += sizeof(size_t);
+    std::memcpy(buffer.get() + offset, &count, sizeof(size_t)); offset += sizeof(size_t);
+    for (const auto& id : txids) {
+        std::vector<unsigned char> raw;
+        if (!util::fromHex(id, raw) || raw.size() != idSize) {
+            raw.assign(idSize, 0); // never matches a real txid, the receiver drops it
+        }
+        std::memcpy(buffer.get() + offset, raw.data(), idSize); offset += idSize;
     }
-
     return buffer;
 }
 
-/* Deserialize Wallet info */
-walletInfo Peer::deserializeWalletInfo(const std::unique_ptr<unsigned char[]>& buffer) {
-    walletInfo info;
-    size_t offset = 0;
+bool Peer::deserializeTxids(const std::unique_ptr<unsigned char[]>& buffer, std::vector<std::string>& txids) {
+    constexpr size_t idSize = 32;
+    txids.clear();
+    if (!buffer) {
+        return false;
+    }
 
-    /* Deserialize tSize (not used in this function, but read to advance the offset) */
-    size_t tSize;
-    std::memcpy(&tSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize addrSize */
-    size_t addrSize;
-    std::memcpy(&addrSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize pubKeySize */
-    size_t pubKeySize;
-    std::memcpy(&pubKeySize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize clientID */
-    std::memcpy(&info.clientID, buffer.get() + offset, sizeof(uint32_t));
-    offset += sizeof(uint32_t);
-
-    /* Deserialize WallAddress */
-    info.walladdr.resize(addrSize);
-    info.walladdr.assign(reinterpret_cast<const char*>(buffer.get() + offset), addrSize - 1);
-    offset += addrSize;
-
-    /* Deserialize pubKeyy (EVP_PKEY*) */
-    if (pubKeySize > 0) {
-        const unsigned char* tempPtr = buffer.get() + offset;
-        EVP_PKEY* temp = d2i_PUBKEY(nullptr, &tempPtr, pubKeySize);
-        info.pubKeyy.reset(temp, EVP_PKEY_Deleter());
-        offset += pubKeySize;
+    size_t tSize = 0, count = 0;
+    std::memcpy(&tSize, buffer.get(), sizeof(size_t));
+    if (tSize < sizeof(size_t) * 2) {
+        return false;
     }
-    else {
-        info.pubKeyy = nullptr;
+    std::memcpy(&count, buffer.get() + sizeof(size_t), sizeof(size_t));
+    if (count > maxInvPerMsg || count * idSize != tSize - sizeof(size_t) * 2) {
+        return false;
     }
 
-    return info;
-}
\ No newline at end of file
+    txids.reserve(count);
+    const unsigned char* p = buffer.get() + sizeof(size_t) * 2;
+    for (size_t i = 0; i < count; i++, p += idSize) {
+        txids.push_back(util::toHex(p, idSize));
+    }
+    return true;
+}
@@ -16,6 +16,16 @@
 #include "Coin.h"
 #include "Consensus.h"
 #include "Trainer.h"
+#include "Mempool.h"
+#include "BlockTemplate.h"
+#include "SigCache.h"
+#include "Inventory.h"
+#include "RollingBloom.h"
+#include "CompactBlock.h"
+#include "ChainSync.h"
+#include "ByteIO.h"
+#include "Snapshot.h"
+#include "BlockPipeline.h"
 
 // Message Types
 enum class CustomMsgTypes : uint32_t
@@ -27,15 +37,28 @@ enum class CustomMsgTypes : uint32_t
 	TxRecieved,
 	BlkRecieved,
 	StartComplete,
-	PopulateChain,
 	WalletInfo,
 	DelegateID,
 	Votes,
 	Chain,
+	TxInv,
+	GetTxs,
+	CmpctBlock,
+	GetBlockTxs,
+	BlockTxs,
+	GetBlk,
+	GetHeaders,
+	Headers,
+	GetBlocks,
+	Blocks,
+	GetSnapshot,
+	Snapshot,
+	SyncedBlocks, // local only, wakes the message thread for bodies the sync pipeline finished
+	SyncTick, // local only, posted each second by the block thread for the sync timers
 };
 
 struct servID { std::string host;  uint16_t portNum = 0; };
-struct walletInfo { uint32_t clientID = 0; std::string walladdr; EVP_PKEY_ptr pubKeyy; };
+struct walletInfo { uint32_t clientID = 0; Address walladdr; EVP_PKEY_ptr pubKeyy; };
 
 /* Server Class */
 class Peer : public olc::net::peer_interface<CustomMsgTypes> {
@@ -50,7 +73,7 @@ protected:
 	servID serverID;
 	Consensus consensus;
 	std::string delegateID;
-	std::string currentDelegate;
+	IdHandle currentDelegate = Interner::NONE;
 	unsigned short sPeriod;
 	BlockChain* chain;
 	std::thread tMsg; // This Thread Manages Messages
@@ -59,9 +82,59 @@ protected:
 	std::thread tTrn; // This thread manages AI Training
 	unsigned long long created; // Time Server Was Created
 	std::vector<servID> nodeID; // List of Servers Structs
-	std::vector<Block*> block_pool;
-	std::vector<walletInfo> wallets;
-	std::vector<transactions> mempool;
+	std::unordered_map<Address, walletInfo, AddressHash> wallets;
+	/* Txs leaving the pool (evicted, mined or removed) leave the template with it */
+	Mempool mempool{Mempool::DEFAULT_MAX_BYTES, [this](const std::vector<std::string>& txids) { blkTemplate.drop(txids); }};
+	BlockTemplate blkTemplate; // next block, kept current as txs arrive
+	SigCache sigCache; // signatures already verified by this node
+	unsigned long long lastMempoolDump = 0;
+	bool mempoolLoaded = false;
+	static constexpr unsigned long long mempoolDumpPeriod = 60; // seconds
+
+	/* Inventory relay, txids are announced in batches & bodies sent on request only */
+	std::mutex mtxInv; // guards the inventory state, shared by the message & block threads
+	std::unordered_map<uint32_t, InvFilter> peerKnown; // txids each connected peer already has
+	std::vector<std::string> invQueue; // accepted txids awaiting announcement
+	struct InvRequest { unsigned long long at = 0; uint32_t peer = 0; };
+	std::unordered_map<std::string, InvRequest> invRequested; // txid -> when & from whom it was requested
+	std::unordered_map<uint32_t, size_t> invOpen; // requests each peer has not answered yet
+	unsigned long long lastInvFlush = 0;
+	static constexpr size_t maxInvPerMsg = 500;
+	static constexpr size_t maxInvPerPeer = 500; // an announcer past this is not asked until it answers
+	static constexpr size_t maxInvRequested = 5000;
+	static constexpr unsigned long long invRequestTimeout = 30; // seconds
+	RollingBloom seenMsgs; // digests of gossip recently handled or sent by this node
+
+	/* Compact blocks waiting for txs requested with GetBlockTxs, by block hash (hex) */
+	std::unordered_map<std::string, PartialBlock> pendingCompact;
+	static constexpr size_t maxPendingCompact = 8;
+
+	/* Headers-first download, bodies pulled in ranges from every connected peer */
+	ChainSync chainSync;
+	unsigned long long lastSyncTick = 0; // last SyncTick posted by blkLoop
+	std::mutex mtxSync; // guards syncedBlocks, filled by the pipeline's sink & drained by the message thread
+	std::deque<Block*> syncedBlocks;
+
+	/* Synced bodies are decoded & checked on the pipeline's workers, then queued in order for the
+	   message thread, the only one applying blocks to the chain, wallet & consensus */
+	BlockPipeline syncPipeline{[this](Block* nb) { syncedBlock(nb); }};
+
+	/* State snapshots, taken every Snapshot::INTERVAL confirmed heights & committed by the next block */
+	bool fastSync = true; // a joining node starts from a committed snapshot when the header chain has one
+	unsigned int snapshotHeight = 0; // latest snapshot taken or imported, 0 = none
+	std::vector<unsigned char> snapshotDigest;
+	/* Request state below is only touched on the message thread, the timeout runs on SyncTick */
+	unsigned int wantedSnapshot = 0; // height requested by a fast sync, 0 = not waiting
+	std::vector<unsigned char> wantedDigest; // what the header chain commits to for it
+	unsigned long long snapshotRequested = 0;
+	std::unique_ptr<Snapshot> pendingImport; // verified, applied once its anchor block arrives
+
+	/* Last block confirm() applied to the wallet & consensus, guarded by mtxB like the chain */
+	Block* walletConfirmed = nullptr;
+
+	/* What each recent block changed in this node, by height, reverted when a reorg takes it off.
+	   Written by blkRqMethod & confirm() on the block thread, erased by a reorg on the message thread, all under mtxB */
+	std::map<unsigned int, NodeUndo> nodeUndo;
 
 	virtual bool OnPeerConnect(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer) override
 	{
@@ -76,6 +149,14 @@ protected:
 	{
 		if (peer) {
 			std::cout << "[NetworkManager] Peer disconnected, ID: " << peer->GetID() << "\n";
+			chainSync.peerGone(peer->GetID());
+			std::lock_guard<std::mutex> lock(mtxInv);
+			peerKnown.erase(peer->GetID());
+
+			/* Its open requests go, so another announcer can be asked */
+			const uint32_t gone = peer->GetID();
+			std::erase_if(invRequested, [gone](const auto& r) { return r.second.peer == gone; });
+			invOpen.erase(gone);
 			util::logCall("NETWORK", "OnPeerDisconnect()", true);
 		}
 		else {
@@ -88,6 +169,16 @@ protected:
 	virtual void OnMessage(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, olc::net::message<CustomMsgTypes>& msg) override
 	{
 		util::logCall("NETWORK", "OnMessage()", true);
+
+		/* Gossip echoes are dropped here, before any decoding */
+		if (isGossip(msg.header.id) && !firstSeen(msg)) {
+			util::logCall("NETWORK", "OnMessage()", true, "Duplicate Dropped");
+			return;
+		}
+
+		/* Handlers link, reorg & prune the chain the block thread produces on, both run under mtxB */
+		std::lock_guard<std::mutex> chainLock(mtxB);
+
 		switch (msg.header.id)
 		{
 			case CustomMsgTypes::ChatMessage:
@@ -95,22 +186,24 @@ protected:
 				std::cout << "Chat Message\n";
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				size_t offset = 0;
-				size_t dataSize = 0;
-				std::memcpy(&dataSize, rec.get() + sizeof(size_t), sizeof(size_t)); offset = (sizeof(size_t) * 2);
-				std::unique_ptr<unsigned char[]> data(new unsigned char[dataSize]);
-				std::memcpy(data.get(), rec.get() + offset, dataSize);
-				std::string chatText = util::toString(data.get());
+				std::string chatText;
+				if (!deserializeText(rec, chatText)) {
+					break;
+				}
 				std::cout << "[This Peer] Chat from peer " << (peer ? std::to_string(peer->GetID()) : "unknown")
 						  << ": " << chatText << "\n";
 				util::logCall("NETWORK", "OnMessage(ChatMessage)", true);
 			}
+			break;
 			case CustomMsgTypes::Consensus:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
 				std::tuple<unsigned long long, unsigned long long, unsigned long, unsigned short, unsigned short,
-				float, float> cns = consensus.deserializeConsensus(rec);
+				float, float> cns;
+				if (!consensus.deserializeConsensus(rec, cns)) {
+					break;
+				}
 				unsigned long long timestamp = std::get<0>(cns);
 				unsigned long long lastUPD = std::get<1>(cns);
 				unsigned long votingPeriod = std::get<2>(cns);
@@ -134,7 +227,10 @@ protected:
 				std::cout << "ServerStart Message\n";
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				servID newNode = deserializeStruct(rec);
+				servID newNode;
+				if (!deserializeStruct(rec, newNode)) {
+					break;
+				}
 				nodeID.push_back(newNode);
 
 				/* Send Current Chain State */
@@ -143,36 +239,7 @@ protected:
 				chn << chain->serializeInfo();
 				SendToPeer(peer, chn);
 
-				/* Send Information For New Node */
-				auto* curr_blk = chain->getFirstBlock();
-				int i = 0;
-				if (curr_blk->next == nullptr) {
-					std::unique_ptr<unsigned char[]> block_ser = curr_blk->serialize();
-					olc::net::message<CustomMsgTypes> newBlk;
-					newBlk.header.id = CustomMsgTypes::PopulateChain;
-					newBlk << block_ser;
-					SendToPeer(peer, newBlk);
-				}
-				else {
-					do {
-						std::unique_ptr<unsigned char[]> block_ser = curr_blk->serialize();
-						curr_blk = curr_blk->next;
-						olc::net::message<CustomMsgTypes> newBlk;
-						newBlk.header.id = CustomMsgTypes::PopulateChain;
-						newBlk << block_ser;
-						SendToPeer(peer, newBlk);
-						i++;
-					} while (curr_blk->next != nullptr);
-
-					/* Serialize Final Block */
-					std::unique_ptr<unsigned char[]> block_ser = curr_blk->serialize();
-					curr_blk = nullptr;
-					olc::net::message<CustomMsgTypes> newBlk;
-					newBlk.header.id = CustomMsgTypes::PopulateChain;
-					newBlk << block_ser;
-					SendToPeer(peer, newBlk);
-				}
-				/* Signal The End Of Block Transmission */
+				/* The new node pulls the chain itself (headers first), signal it can start */
 				olc::net::message<CustomMsgTypes> strComplete;
 				strComplete.header.id = CustomMsgTypes::StartComplete;
 				SendToPeer(peer, strComplete);
@@ -195,6 +262,7 @@ protected:
 				olc::net::message<CustomMsgTypes> node;
 				node.header.id = CustomMsgTypes::KnownNode;
 				node << rec;
+				firstSeen(node);
 				this->Broadcast(node);
 				util::logCall("NETWORK", "OnMessage(ServerStart)", true);
 			}
@@ -202,48 +270,148 @@ protected:
 			case CustomMsgTypes::StartComplete:
 			{
 				std::cout << "StartComplete Message\n";
+				startSync(peer);
+			}
+			break;
+			case CustomMsgTypes::GetHeaders:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				unsigned int from = 0;
+				if (!readHeight(rec, from) || chain->empty()) {
+					break;
+				}
 
-				/* Sort Blocks From Lowest To Highest by Block height */
-				std::ranges::sort(block_pool, [](const Block* a, const Block* b)
-				                  {return a->getBlockHeight() < b->getBlockHeight();});
-
-				/* Verify & Populate Chain */
-				size_t pos = 0;
-
-				for (auto& it : block_pool) {
-					if (pos == 0) {
-						chain->initial(it);
-						chain->setChnTmstmp(it->getTimestamp());
-						verifyMempool();
-						confirm();
-						util::logCall("NETWORK", "OnMessage(StartComplete - Initial)", true);
-						pos++;
-					}
-					else {
-						if (chain->verifyBlockchain()) {
-							chain->GenerateBlock(it->getData(), it);
-							chain->setVersion(it->getVersion());
-							verifyMempool();
-							confirm();
-							util::logCall("NETWORK", "OnMessage(StartComplete - NextBlk)", true);
-						}
-					}
+				/* A fast-synced node holds nothing below its snapshot anchor, it refuses with no headers
+				   rather than a chain the requester could not link, & the requester tries another peer */
+				const unsigned int anchor = chain->getFirstBlock()->getBlockHeight();
+				std::vector<BlockHeader> list;
+				for (unsigned int h = from; from >= anchor && list.size() < ChainSync::MAX_HEADERS; h++) {
+					const Block* b = chain->blockAt(h);
+					if (b == nullptr) break;
+					list.push_back(BlockHeader::of(b));
+				}
+				olc::net::message<CustomMsgTypes> resp;
+				resp.header.id = CustomMsgTypes::Headers;
+				resp << BlockHeader::serializeList(list);
+				SendToPeer(peer, resp);
+			}
+			break;
+			case CustomMsgTypes::Headers:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				std::vector<BlockHeader> list;
+				if (!chainSync.active() || chainSync.headersDone()) {
+					break;
+				}
+				if (!BlockHeader::deserializeList(rec, list) || !chainSync.addHeaders(list)) {
+					std::cout << "Chain sync aborted: invalid headers\n";
+					chainSync.finish();
+					break;
+				}
+
+				/* A full batch means more may follow, the bodies start once the header chain ends */
+				if (list.size() == ChainSync::MAX_HEADERS) {
+					requestHeaders(peer, chainSync.nextHeaderHeight());
+					break;
+				}
+				if (chain->empty() && chainSync.nextHeaderHeight() == 0) {
+					/* No chain from genesis, the peer cannot serve one (e.g. fast-synced past it) */
+					std::cout << "Chain sync aborted: no headers from genesis\n";
+					chainSync.finish();
+					syncFromNext(peer);
+					break;
+				}
+				chainSync.setHeadersDone();
+				std::cout << "Headers synced to height " << chainSync.nextHeaderHeight() << ", downloading blocks\n";
+				if (requestSnapshot(peer)) {
+					break; // bodies start at the snapshot anchor once it is verified
+				}
+				applySynced();
+				scheduleBodies();
+			}
+			break;
+			case CustomMsgTypes::GetSnapshot:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				unsigned int height = 0;
+				Snapshot snap;
+				if (!readHeight(rec, height) || height == 0 || !Snapshot::load(snapshotPath(height), snap)) {
+					/* An empty reply tells the requester to fall back to a full sync */
+					olc::net::message<CustomMsgTypes> none;
+					none.header.id = CustomMsgTypes::Snapshot;
+					none << ByteWriter{}.finish();
+					SendToPeer(peer, none);
+					break;
 				}
+				olc::net::message<CustomMsgTypes> resp;
+				resp.header.id = CustomMsgTypes::Snapshot;
+				resp << snap.serialize();
+				SendToPeer(peer, resp);
+				util::logCall("NETWORK", "OnMessage(GetSnapshot)", true);
 			}
 			break;
-			case CustomMsgTypes::PopulateChain:
+			case CustomMsgTypes::Snapshot:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				Block* nb = chain->getCurrBlock()->deserialize(rec);
-				block_pool.emplace_back(nb);
+				if (wantedSnapshot == 0) {
+					break; // not asked for, or already timed out
+				}
+				auto snap = std::make_unique<Snapshot>();
+				if (!Snapshot::deserialize(rec, *snap) || !acceptSnapshot(std::move(snap))) {
+					std::cout << "Snapshot rejected, syncing from genesis\n";
+				}
+				wantedSnapshot = 0;
+				applySynced();
+				scheduleBodies();
+			}
+			break;
+			case CustomMsgTypes::GetBlocks:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				ByteReader r;
+				unsigned int from = 0, count = 0;
+				if (!r.open(rec) || !r.read(&from, sizeof(unsigned int)) || !r.read(&count, sizeof(unsigned int))) {
+					break;
+				}
+				sendBlocks(peer, from, std::min(count, ChainSync::RANGE_SIZE));
+			}
+			break;
+			case CustomMsgTypes::Blocks:
+			{
+				/* One frame, many blocks: each one's bytes go to the validation pipeline,
+				   its sink applies them as soon as every lower height is, the rest wait in the window */
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				ByteReader r;
+				size_t count = 0;
+				if (!r.open(rec) || !r.read(&count, sizeof(size_t)) || count > ChainSync::RANGE_SIZE) {
+					util::logCall("NETWORK", "OnMessage(Blocks)", false, "Malformed Frame");
+					break;
+				}
+				for (size_t i = 0; i < count; i++) {
+					const unsigned char* start = nullptr;
+					size_t bSize = 0;
+					if (!r.view(start, bSize)) {
+						util::logCall("NETWORK", "OnMessage(Blocks)", false, "Truncated Frame");
+						break;
+					}
+					syncPipeline.submit(start, bSize);
+				}
 			}
 			break;
 			case CustomMsgTypes::KnownNode:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				servID newNode = deserializeStruct(rec);
+				servID newNode;
+				if (!deserializeStruct(rec, newNode)) {
+					break;
+				}
 				bool present = false;
 				for (auto& it : nodeID) {
 					if (newNode.portNum == it.portNum && newNode.host == it.host) {
@@ -263,62 +431,245 @@ protected:
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
 				utxout uin;
-				uin = w1.deserialize_utxout(rec);
-				mempool_emplace(uin);
-				broadcastTransaction(uin);
+				if (!w1.deserialize_utxout(rec, uin)) {
+					break;
+				}
+
+				/* Accepted txs are queued for announcement, never pushed back out in full */
+				mempool_emplace(uin, peer ? peer->GetID() : 0);
+			}
+			break;
+			case CustomMsgTypes::TxInv:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				std::vector<std::string> txids;
+				if (!deserializeTxids(rec, txids)) {
+					util::logCall("NETWORK", "OnMessage(TxInv)", false, "Malformed Inventory");
+					break;
+				}
+
+				if (peer == nullptr) {
+					break;
+				}
+
+				/* Request only what neither the pool, the chain nor an earlier request covers,
+				   within the per peer & total bounds on open requests */
+				std::vector<std::string> wanted;
+				{
+					std::lock_guard<std::mutex> lock(mtxInv);
+					InvFilter& known = peerKnown[peer->GetID()];
+					size_t& open = invOpen[peer->GetID()];
+					const unsigned long long now = util::TimeStamp();
+					for (const auto& id : txids) {
+						known.insert(id);
+						if (mempool.contains(id) || !chain->isNewTxid(id) || invRequested.contains(id)) {
+							continue;
+						}
+						if (open >= maxInvPerPeer || invRequested.size() >= maxInvRequested) {
+							break;
+						}
+						invRequested.emplace(id, InvRequest{now, peer->GetID()});
+						open++;
+						wanted.push_back(id);
+					}
+				}
+
+				if (!wanted.empty()) {
+					olc::net::message<CustomMsgTypes> req;
+					req.header.id = CustomMsgTypes::GetTxs;
+					req << serializeTxids(wanted);
+					SendToPeer(peer, req);
+				}
+				util::logCall("NETWORK", "OnMessage(TxInv)", true);
+			}
+			break;
+			case CustomMsgTypes::GetTxs:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				std::vector<std::string> txids;
+				if (!deserializeTxids(rec, txids)) {
+					util::logCall("NETWORK", "OnMessage(GetTxs)", false, "Malformed Request");
+					break;
+				}
+
+				for (const auto& id : txids) {
+					utxout uin;
+					if (!mempool.get(id, uin)) {
+						continue; // mined or evicted since the announcement
+					}
+					olc::net::message<CustomMsgTypes> tx;
+					tx.header.id = CustomMsgTypes::TxRecieved;
+					tx << w1.serialize_utxout(uin);
+					SendToPeer(peer, tx);
+				}
+				util::logCall("NETWORK", "OnMessage(GetTxs)", true);
 			}
 			break;
 			case CustomMsgTypes::BlkRecieved:
 			{
-				if (chain->verifyBlockchain()) {
+				if (!chain->empty() && !chainSync.active() && chain->verifyBlockchain()) {
 					std::unique_ptr<unsigned char[]> rec;
 					msg >> rec;
 					Block* nb = chain->getCurrBlock()->deserialize(rec);
-					chain->GenerateBlock(nb->getData(), nb);
-					chain->setVersion(nb->getVersion());
-					verifyMempool();
-					confirm();
+					linkBlock(peer, nb);
 				}
 			}
 			break;
-			case CustomMsgTypes::WalletInfo:
+			case CustomMsgTypes::CmpctBlock:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				walletInfo wi;
-				wi = deserializeWalletInfo(rec);
-				bool present = false;
-				for (auto& wal: wallets) {
-					if (wal.walladdr == wi.walladdr) {
-						present = true;
-					}
+				CompactBlock cb;
+				if (!CompactBlock::deserialize(rec, cb)) {
+					break;
 				}
 
-				if (!present) {
-					wallets.push_back(wi);
+				if (chain->empty() || chainSync.active()) {
+					break; // still syncing, the block comes with the download or the catch-up after it
+				}
+
+				/* Only the next block is rebuilt from the pool, a node far behind catches up through a sync */
+				Block* tip = chain->getCurrBlock();
+				if (cb.height > chain->getBlockHeight() + maxOrphanGap) {
+					startSync(peer);
+					break;
 				}
+				if (cb.height + chain->getConf() <= chain->getBlockHeight()) {
+					util::logCall("NETWORK", "OnMessage(CmpctBlock)", false, "Below Confirmed Height");
+					break;
+				}
+				if (cb.height != chain->getBlockHeight() + 1 || cb.prevHash != tip->getCurrHash()) {
+					/* A side branch or a block ahead of its parent, fetched whole for the block tree */
+					requestFullBlock(peer, cb.height);
+					break;
+				}
+
+				PartialBlock pb(std::move(cb));
+				pb.fill(mempool);
+				const std::vector<uint32_t> missing = pb.missing();
+				if (missing.empty()) {
+					completeCompact(peer, pb);
+					break;
+				}
+
+				/* Ask the announcer for what the pool lacks */
+				const CompactBlock& head = pb.getCompact();
+				olc::net::message<CustomMsgTypes> req;
+				req.header.id = CustomMsgTypes::GetBlockTxs;
+				req << CompactBlock::serializeRequest(head.height, head.currHash, missing);
+				SendToPeer(peer, req);
+
+				if (pendingCompact.size() >= maxPendingCompact) {
+					pendingCompact.clear();
+				}
+				const std::string key = util::toHex(head.currHash.data(), head.currHash.size());
+				pendingCompact.insert_or_assign(key, std::move(pb));
+				util::logCall("NETWORK", "OnMessage(CmpctBlock)", true, "Txs Requested");
 			}
 			break;
-			case CustomMsgTypes::DelegateID:
+			case CustomMsgTypes::GetBlockTxs:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				size_t offset = 0;
-				size_t dataSize = 0;
-				std::memcpy(&dataSize, rec.get() + sizeof(size_t), sizeof(size_t)); offset = (sizeof(size_t) * 2);
-				std::unique_ptr<unsigned char[]> data(new unsigned char[dataSize]);
-				std::memcpy(data.get(), rec.get() + offset, dataSize);
-				std::string id = util::toString(data.get());
-				std::vector<std::string> IDs = consensus.getDelegateIDs();
-				bool present = false;
+				unsigned int height = 0;
+				std::vector<unsigned char> hash;
+				std::vector<uint32_t> indices;
+				if (!CompactBlock::deserializeRequest(rec, height, hash, indices)) {
+					break;
+				}
 
-				for (auto& it: IDs) {
-					if (id == it) {
-						present = true;
+				Block* blk = chain->blockAt(height);
+				if (blk == nullptr || blk->getCurrHash() != hash) {
+					util::logCall("NETWORK", "OnMessage(GetBlockTxs)", false, "Unknown Block");
+					break;
+				}
+				const std::vector<transactions> data = blk->getData();
+				std::vector<uint32_t> sent;
+				std::vector<transactions> txs;
+				for (const uint32_t i : indices) {
+					if (i != 0 && i < data.size()) {
+						sent.push_back(i);
+						txs.push_back(data[i]);
 					}
 				}
+				olc::net::message<CustomMsgTypes> resp;
+				resp.header.id = CustomMsgTypes::BlockTxs;
+				resp << CompactBlock::serializeTxs(hash, sent, txs);
+				SendToPeer(peer, resp);
+			}
+			break;
+			case CustomMsgTypes::BlockTxs:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				std::vector<unsigned char> hash;
+				std::vector<uint32_t> indices;
+				std::vector<std::unique_ptr<unsigned char[]>> bufs;
+				if (!CompactBlock::deserializeTxs(rec, hash, indices, bufs)) {
+					break;
+				}
 
-				if (!present) {
+				const auto it = pendingCompact.find(util::toHex(hash.data(), hash.size()));
+				if (it == pendingCompact.end()) {
+					break;
+				}
+				PartialBlock pb = std::move(it->second);
+				pendingCompact.erase(it);
+
+				bool ok = true;
+				for (size_t i = 0; i < bufs.size() && ok; i++) {
+					std::optional<transactions> tx;
+					ok = transactions::decode(bufs[i], tx) && pb.provide(indices[i], *tx);
+				}
+				if (ok) {
+					completeCompact(peer, pb);
+				}
+				else {
+					requestFullBlock(peer, pb.getCompact().height);
+				}
+			}
+			break;
+			case CustomMsgTypes::GetBlk:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				unsigned int height = 0;
+				if (!readHeight(rec, height)) {
+					break;
+				}
+
+				if (const Block* blk = chain->blockAt(height); blk != nullptr && !blk->isPruned()) {
+					olc::net::message<CustomMsgTypes> full;
+					full.header.id = CustomMsgTypes::BlkRecieved;
+					full << blk->serialize();
+					SendToPeer(peer, full);
+				}
+			}
+			break;
+			case CustomMsgTypes::WalletInfo:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				walletInfo wi;
+				if (!deserializeWalletInfo(rec, wi)) {
+					break;
+				}
+				const Address wid = wi.walladdr;
+				wallets.try_emplace(wid, std::move(wi));
+			}
+			break;
+			case CustomMsgTypes::DelegateID:
+			{
+				std::unique_ptr<unsigned char[]> rec;
+				msg >> rec;
+				std::string id;
+				if (!deserializeText(rec, id)) {
+					break;
+				}
+
+				if (!consensus.delIDExist(id)) {
 					consensus.addDelegateID(id);
 					broadcastDelegateID(id);
 				}
@@ -328,22 +679,16 @@ protected:
 			{
 				std::unique_ptr<unsigned char[]> rec;
 				msg >> rec;
-				std::vector<std::tuple<std::string, std::string, float>> votes = Consensus::deserializeVector(rec);
-
-				/* Compare for Duplicates */
-				bool present = false;
-				std::vector<std::tuple<std::string, std::string, float>> vQueue = consensus.getVotesQueue();
-
-				for (auto& it: votes) {
-					for (auto& it2: vQueue) {
-						if (std::get<0>(it) == std::get<0>(it2) && std::get<1>(it) == std::get<1>(it2) && std::get<2>(it) == std::get<2>(it2)) {
-							present = true;
-						}
+				std::vector<std::tuple<Address, std::string, float>> votes;
+				if (!Consensus::deserializeVector(rec, votes)) {
+					break;
+				}
 
-						if (!present) {
-							vote(votes);
-						}
-					}
+				/* Drop votes already seen this epoch, apply & relay the rest exactly once */
+				std::vector<std::tuple<Address, IdHandle, float>> fresh = consensus.filterNewVotes(votes);
+				if (!fresh.empty()) {
+					consensus.updatedVotes(fresh);
+					broadcastVotes(toVoteStrings(fresh));
 				}
 			}
 				break;
@@ -354,15 +699,51 @@ protected:
 				msg >> rec;
 				chain->deserializeInfo(rec);
 			}
+				break;
+			case CustomMsgTypes::SyncedBlocks:
+			{
+				if (peer != nullptr) {
+					break; // posted by the sync pipeline only, never taken off the wire
+				}
+				drainSynced();
+			}
+				break;
+			case CustomMsgTypes::SyncTick:
+			{
+				if (peer != nullptr) {
+					break; // posted by blkLoop only, never taken off the wire
+				}
+				/* A snapshot that never came means a full sync from genesis */
+				if (wantedSnapshot != 0 && util::TimeStamp() - snapshotRequested >= ChainSync::RANGE_TIMEOUT) {
+					std::cout << "Snapshot request timed out, syncing from genesis\n";
+					wantedSnapshot = 0;
+				}
+				/* Body ranges held too long by a slow peer are handed to another */
+				if (chainSync.active() && wantedSnapshot == 0) {
+					scheduleBodies();
+				}
+			}
+				break;
 		}
 	}
 private:
 	/* Variable */
 	std::mutex mtxA; // Shared mutex for messages
-	std::mutex mtxB; // Shared mutex for blocks
+	mutable std::mutex mtxB; // Shared mutex for blocks: chain, wallet, undo state
 	std::mutex mtxC; // Shared mutex consensus
 	std::mutex mtxD; // Shared mutex AI
 
+	/* Wire layouts: servID as tSize | host size (NUL included) | port | host,
+	   walletInfo as tSize | address size | key size | clientID | address | DER key (none if null) */
+	using ServIDWire = serial::Layout<servID, serial::Extent<&servID::host>, serial::Field<&servID::portNum>,
+		serial::Field<&servID::host>>;
+	using WalletInfoWire = serial::Layout<walletInfo, serial::Extent<&walletInfo::walladdr>,
+		serial::Extent<&walletInfo::pubKeyy>, serial::Field<&walletInfo::clientID>, serial::Field<&walletInfo::walladdr>,
+		serial::Field<&walletInfo::pubKeyy>>;
+
+	/* Chat text & delegate IDs: tSize | text size | text (no NUL) */
+	using TextWire = serial::Layout<std::string, serial::FieldAs<serial::LenStr<size_t>>>;
+
 
 public:
 	/* Constructor */
@@ -378,6 +759,10 @@ public:
 		tBlk.join();
 		tCns.join();
 		tTrn.join();
+		syncPipeline.stop();
+		for (Block* nb : syncedBlocks) {
+			delete nb;
+		}
 		delete chain;
 		this->Stop();
 	}
@@ -409,20 +794,81 @@ public:
 	/* Update Time slot max seconds! */
 	void updateSlot();
 
-	/* Add Transactions To The Mempool */
-	void mempool_emplace(const utxout& uin);
+	/* Add Transactions To The Mempool, fromPeer (0 = local) is marked as already knowing it */
+	bool mempool_emplace(const utxout& uin, uint32_t fromPeer = 0);
+
+	/* Announce queued txids to every peer that does not know them yet (Called from the block loop) */
+	void flushInventory();
 
-	/* Update mempool (Called everytime tx is received) */
+	/* Closes an open tx request, freeing its slot in the announcer's count (mtxInv held) */
+	void closeInvRequest(std::unordered_map<std::string, InvRequest>::iterator it);
+
+	/* Relayed message types, deduplicated by seenMsgs. Txs are not: they only arrive as replies to
+	   GetTxs, & inventory already keeps a txid from being requested twice */
+	static bool isGossip(CustomMsgTypes id);
+
+	/* Records a message digest, false if this node already handled or sent it */
+	bool firstSeen(const olc::net::message<CustomMsgTypes>& msg);
+
+	/* Mempool persistence, binary dump of signed txs + signature cache digests */
+	bool dumpMempool(const std::string& path = "mempool.dat");
+	bool writeMempool(const std::vector<utxout>& pool, const std::string& path = "mempool.dat");
+	size_t loadMempool(const std::string& path = "mempool.dat");
+
+	/* Drop mempool txs the latest block contains & restart the block template (Called everytime a block is linked) */
 	void verifyMempool();
 
+	/* Refill the block template from the mempool's best paying txs */
+	void rebuildTemplate();
+
+	/* Drop a linked block's txs from the mempool, keeping them in its undo record */
+	void unpoolBlock(const Block* b);
+
 	/* add new block to chain */
 	void blkRqMethod();
 
+	/* Hands a received block to the block tree, deleted if it does not verify; an orphan's parent is requested */
+	void linkBlock(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, Block* nb);
+	static constexpr unsigned int maxOrphanGap = 16; // heights above the tip fetched one by one, beyond is a sync
+
+	/* Mempool, block template & confirmations after the tip moved, by one block or a reorg */
+	void applyTipChange(const TipChange& change);
+
+	/* Reverts a disconnected block's wallet, consensus & supply effects from its undo record */
+	void revertBlock(unsigned int height);
+
+	/* Headers-first sync: start after the local tip, request headers & body ranges, apply in order */
+	void startSync(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer);
+	void syncFromNext(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer);
+	void requestHeaders(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, unsigned int from);
+	void scheduleBodies();
+
+	/* Answers GetBlocks, blocks packed into Blocks frames of at most maxFrameBytes */
+	void sendBlocks(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, unsigned int from, unsigned int count);
+	static constexpr size_t maxFrameBytes = 8000000;
+	void applySynced();
+	void syncedBlock(Block* nb);
+	void drainSynced();
+	static bool readHeight(const std::unique_ptr<unsigned char[]>& buffer, unsigned int& height);
+
+	/* Snapshots: taken on confirmation, checked against a block's commitment, fetched by a fast sync */
+	static std::string snapshotPath(unsigned int height);
+	void takeSnapshot();
+	std::vector<unsigned char> nextCommitment();
+	bool commitmentValid(const Block* nb);
+	bool requestSnapshot(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer);
+	bool acceptSnapshot(std::unique_ptr<Snapshot> snap);
+	void restoreSnapshot(const Snapshot& snap);
+
+	/* Builds & links a fully reconstructed compact block, full block fallback on mismatch */
+	void completeCompact(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, const PartialBlock& pb);
+	void requestFullBlock(std::shared_ptr<olc::net::connection<CustomMsgTypes>> peer, unsigned int height);
+
 	/* Update Coin */
 	void updateCoins(transactions rew);
 
 	/*Alert Delegate to Generate block*/
-	void voteDelegate(const std::vector<std::tuple<std::string, std::string, float>>&);
+	void voteDelegate(const std::vector<std::tuple<Address, std::string, float>>&);
 
 	/* Request to be a delegate */
 	std::string requestDelegate();
@@ -431,25 +877,40 @@ public:
 	void confirm();
 
 	/* Get Wallets Balance */
-	double getBalance() const;
+	Amount getBalance() const;
+
+	/* Confirmed balance of any address from the chain index */
+	Amount getAddressBalance(const Address& wa) const;
 
 	/* Change Wallet Address to existing Address */
-	void set_address(const std::string& wa);
+	void set_address(const Address& wa);
 
 	/* Get Instance Delegate ID */
 	std::string get_this_delID() const;
 
 	/* Get Wallets Address */
-	std::string getWalletAddress() const;
+	Address getWalletAddress() const;
 
 	/* Vote For Delegates */
-	void vote(std::vector<std::tuple<std::string, std::string, float>> votes);
+	void vote(std::vector<std::tuple<Address, std::string, float>> votes);
+
+	/* Resolve interned delegate IDs back to their network (string) form */
+	static std::vector<std::tuple<Address, std::string, float>> toVoteStrings(const std::vector<std::tuple<Address, IdHandle, float>>& votes);
 
 	/* Get List of UTXOs In Wallet */
 	void listTx();
 
+	/* Paged chain history of this wallet, page 0 is the newest */
+	void txHistory(size_t page);
+
 	/* sends transaction and returns success factor */
-	bool sendTx(std::vector<std::string>& recipients, std::vector<double> amounts);
+	bool sendTx(std::vector<Address>& recipients, std::vector<Amount> amounts);
+
+	/* Select the wallet coin selection strategy by name */
+	bool setCoinSelection(const std::string& strategy);
+
+	/* Pruned mode, keep the last keep block bodies (0 = archival), false below the confirmation period */
+	bool setPruning(unsigned int keep);
 
 	/* Display transaction present in blockchain */
 	void getKnownTx(std::string& txid);
@@ -472,18 +933,22 @@ public:
 
 	void broadcastBlock(const Block* block);
 
-	void broadcastVotes(std::vector<std::tuple<std::string, std::string, float>> votes);
-
-	void broadcastTransaction(const utxout& u_out);
+	void broadcastVotes(std::vector<std::tuple<Address, std::string, float>> votes);
 
 	void broadcastDelegateID(const std::string& id);
 
 	/* struct de-serialization methods */
 	std::unique_ptr<unsigned char[]> serializeStruct(const servID& sid);
-	servID deserializeStruct(const std::unique_ptr<unsigned char[]>& buffer);
+	bool deserializeStruct(const std::unique_ptr<unsigned char[]>& buffer, servID& sid);
 
 	std::unique_ptr<unsigned char[]> serializeWalletInfo(const walletInfo& info);
-	walletInfo deserializeWalletInfo(const std::unique_ptr<unsigned char[]>& buffer);
+	bool deserializeWalletInfo(const std::unique_ptr<unsigned char[]>& buffer, walletInfo& info);
+
+	static bool deserializeText(const std::unique_ptr<unsigned char[]>& buffer, std::string& text);
+
+	/* Inventory lists, txids travel as their 32 raw digest bytes */
+	static std::unique_ptr<unsigned char[]> serializeTxids(const std::vector<std::string>& txids);
+	static bool deserializeTxids(const std::unique_ptr<unsigned char[]>& buffer, std::vector<std::string>& txids);
 
 
 };
@@ -92,11 +92,17 @@ namespace olc
 				return msg;
 			}
 
-			// Pulls any POD-like data form the message buffer
+			// Pulls any POD-like data form the message buffer. The size prefix comes from the
+			// peer, a buffer claiming more than the body holds is refused & data is left null
 			friend message<T>& operator >> (message<T>& msg, std::unique_ptr<unsigned char[]>& data)
 			{
 				size_t size = 0;
+				data.reset();
+				if (msg.body.size() < sizeof(size_t))
+					return msg;
 				std::memcpy(&size, msg.body.data(), sizeof(size_t));
+				if (size < sizeof(size_t) || size > msg.body.size())
+					return msg;
 				data = std::make_unique<unsigned char[]>(size);
 				std::memcpy(data.get(), msg.body.data(), size);
 				return msg;
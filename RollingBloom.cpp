@@ -0,0 +1,98 @@
+/*-- RollingBloom.cpp ---------------------------------------------------------
+   This file implements the rolling Bloom filter of recently seen digests.
+-----------------------------------------------------------------------------*/
+#include "RollingBloom.h"
+#include <cmath>
+
+RollingBloom::RollingBloom(const size_t perGeneration, const double fpRate) : perGeneration(perGeneration) {
+    /* Optimal sizing: m = -n ln(p) / ln(2)^2 bits, k = m / n ln(2) hashes */
+    const double ln2 = std::log(2.0);
+    const double bits = -static_cast<double>(perGeneration) * std::log(fpRate) / (ln2 * ln2);
+    numBits = std::max<size_t>(64, static_cast<size_t>(std::ceil(bits / 64.0)) * 64);
+    numHashes = std::clamp(static_cast<unsigned int>(std::lround(bits / perGeneration * ln2)), 1u, 50u);
+
+    for (auto& g : generations) {
+        g.assign(numBits / 64, 0);
+    }
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(&tweak), sizeof(tweak)) != 1) {
+        util::logCall("ROLLINGBLOOM", "RollingBloom()", false, "RAND_bytes Failed");
+        return;
+    }
+    util::logCall("ROLLINGBLOOM", "RollingBloom()", true);
+}
+
+void RollingBloom::hashes(const Digest& d, uint64_t& h1, uint64_t& h2) const {
+    /* The digest is already uniform, two of its words drive double hashing */
+    std::memcpy(&h1, d.data(), sizeof(uint64_t));
+    std::memcpy(&h2, d.data() + sizeof(uint64_t), sizeof(uint64_t));
+    h1 ^= tweak;
+    h2 = (h2 ^ (tweak * 0x9E3779B97F4A7C15ULL)) | 1; // odd, so the k positions differ
+}
+
+bool RollingBloom::test(const std::vector<uint64_t>& bits, const uint64_t h1, const uint64_t h2) const {
+    for (unsigned int i = 0; i < numHashes; i++) {
+        const uint64_t pos = (h1 + i * h2) % numBits;
+        if ((bits[pos >> 6] & (1ULL << (pos & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RollingBloom::insert(const Digest& d) {
+    uint64_t h1 = 0, h2 = 0;
+    hashes(d, h1, h2);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (test(generations[0], h1, h2) || test(generations[1], h1, h2)) {
+        return false;
+    }
+
+    /* Roll: the older generation is wiped and takes the new entries */
+    if (inserted >= perGeneration) {
+        current ^= 1;
+        std::ranges::fill(generations[current], 0);
+        inserted = 0;
+    }
+
+    std::vector<uint64_t>& bits = generations[current];
+    for (unsigned int i = 0; i < numHashes; i++) {
+        const uint64_t pos = (h1 + i * h2) % numBits;
+        bits[pos >> 6] |= 1ULL << (pos & 63);
+    }
+    inserted++;
+    return true;
+}
+
+bool RollingBloom::contains(const Digest& d) const {
+    uint64_t h1 = 0, h2 = 0;
+    hashes(d, h1, h2);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    return test(generations[0], h1, h2) || test(generations[1], h1, h2);
+}
+
+void RollingBloom::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& g : generations) {
+        std::ranges::fill(g, 0);
+    }
+    current = 0;
+    inserted = 0;
+}
+
+bool RollingBloom::digest(const uint32_t tag, const unsigned char* data, const size_t size, Digest& out) {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    unsigned int len = 0;
+    const bool ok = ctx != nullptr
+        && EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) == 1
+        && EVP_DigestUpdate(ctx, &tag, sizeof(tag)) == 1
+        && (size == 0 || EVP_DigestUpdate(ctx, data, size) == 1)
+        && EVP_DigestFinal_ex(ctx, out.data(), &len) == 1
+        && len == DIGEST_SIZE;
+    EVP_MD_CTX_free(ctx);
+    if (!ok) {
+        util::logCall("ROLLINGBLOOM", "digest()", false, "Hash Failed");
+    }
+    return ok;
+}
@@ -0,0 +1,62 @@
+#ifndef ROLLINGBLOOM
+#define ROLLINGBLOOM
+
+#include "util.h"
+#include <array>
+#include <mutex>
+
+/*-- RollingBloom.h -----------------------------------------------------------
+
+  This header file defines a fixed memory filter of recently seen 32 byte
+  digests. It is used to drop gossip echoes (a message this node already
+  handled or sent) before they are decoded.
+
+  The filter keeps two Bloom filter generations. Inserts go to the current
+  one; once it holds `perGeneration` entries the older generation is
+  cleared and becomes current. A digest is therefore remembered for at
+  least perGeneration and at most 2 x perGeneration inserts.
+
+  Basic operations are:
+	 insert:    Records a digest, false if it was (probably) seen before
+	 contains:  True if the digest was (probably) seen before
+	 reset:     Forgets everything
+
+Note:
+  False positives (a new digest reported as seen) happen at roughly
+  fpRate per generation. Bit positions are salted with a random per node
+  tweak, so crafted digests cannot target the same bits on every node.
+  Every member locks the filter, it is shared by the network threads.
+-------------------------------------------------------------------------*/
+
+class RollingBloom
+{
+public:
+	static constexpr size_t DIGEST_SIZE = 32;
+	using Digest = std::array<unsigned char, DIGEST_SIZE>;
+
+	explicit RollingBloom(size_t perGeneration = 50000, double fpRate = 0.000001);
+
+	bool insert(const Digest& d);
+	bool contains(const Digest& d) const;
+	void reset();
+
+	/* SHA-256 of tag || data, the digest this filter is keyed on */
+	static bool digest(uint32_t tag, const unsigned char* data, size_t size, Digest& out);
+
+private:
+	/* Callers hold mtx */
+	bool test(const std::vector<uint64_t>& bits, uint64_t h1, uint64_t h2) const;
+	void hashes(const Digest& d, uint64_t& h1, uint64_t& h2) const;
+
+	size_t perGeneration;
+	size_t numBits;
+	unsigned int numHashes;
+	uint64_t tweak = 0;
+
+	mutable std::mutex mtx;
+	std::array<std::vector<uint64_t>, 2> generations;
+	size_t current = 0;
+	size_t inserted = 0; // entries in the current generation
+};
+
+#endif
@@ -0,0 +1,438 @@
+#ifndef SERIAL
+#define SERIAL
+
+#include "ByteIO.h"
+#include "Address.h"
+#include "CryptoTypes.h"
+#include <array>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+/*-- Serial.h -----------------------------------------------------------------
+
+  This header file defines the schema driven serializer. A type declares
+  its wire layout once, as a list of fields, and gets from it the exact
+  size, the encoder & a bounds checked decoder:
+
+	using Wire = serial::Layout<servID,
+		serial::Extent<&servID::host>,  // size_t, byte size of host
+		serial::Field<&servID::portNum>,
+		serial::Field<&servID::host>>;
+
+  Fields are named by a member path (&A::b, &B::c reads a.b.c, no path is
+  the object itself) & come in three kinds:
+
+	 Field:   The member's encoding, in place
+	 Count:   Element count of a sequence field, read back to size it
+	 Extent:  Byte size of a field's encoding; on decode the field must
+	          fill exactly that many bytes
+
+  Counts & extents default to size_t, CountOf/ExtentOf take the width.
+  The codec is picked from the member's type (numbers raw, Address,
+  NUL terminated strings, byte vectors, vectors & tuples of those, DER
+  public keys); FieldAs names one where the encoding differs.
+
+  Every buffer follows the repo convention: its first size_t is the total
+  size, itself included. decode() rejects anything that runs past it or
+  leaves bytes over, so only the encoding encode() gives decodes.
+
+Note:
+  Decoding fills a Layout::Decoded, read back with at<path>(); types with
+  const members are then built from it, nothing is assigned in place.
+-------------------------------------------------------------------------*/
+
+namespace serial
+{
+	inline constexpr size_t UNSET = static_cast<size_t>(-1);
+
+	/* Member path walk: walk<&A::b, &B::c>(a) is a.b.c */
+	template<class T> const T& walk(const T& obj) { return obj; }
+	template<auto M, auto... R, class T> const auto& walk(const T& obj) { return walk<R...>(obj.*M); }
+
+	template<auto... P> struct Path {};
+
+	/*-- Codecs: size, put (advances the cursor) & get (bounds checked) --*/
+
+	template<class T> struct Raw
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		using type = T;
+		using decoded = T;
+		static constexpr size_t minSize = sizeof(T);
+		static size_t size(const T&) { return sizeof(T); }
+		static void put(unsigned char*& p, const T& v) { std::memcpy(p, &v, sizeof(T)); p += sizeof(T); }
+		static bool get(ByteReader& r, T& v) { return r.read(&v, sizeof(T)); }
+	};
+
+	struct Addr
+	{
+		using type = Address;
+		using decoded = Address;
+		static constexpr size_t minSize = Address::SIZE;
+		static size_t size(const Address&) { return Address::SIZE; }
+		static void put(unsigned char*& p, const Address& a) { std::memcpy(p, a.bytes.data(), Address::SIZE); p += Address::SIZE; }
+		static bool get(ByteReader& r, Address& a) { return r.read(a.bytes.data(), Address::SIZE); }
+	};
+
+	/* NUL terminated, the terminator is searched for within what is left */
+	struct CStr
+	{
+		using type = std::string;
+		using decoded = std::string;
+		static constexpr size_t minSize = 1;
+		static size_t size(const std::string& s) { return s.size() + 1; }
+		static void put(unsigned char*& p, const std::string& s) { std::memcpy(p, s.c_str(), s.size() + 1); p += s.size() + 1; }
+		static bool get(ByteReader& r, std::string& s) {
+			const void* nul = std::memchr(r.p, 0, r.left);
+			if (nul == nullptr) return false;
+			const size_t len = static_cast<const unsigned char*>(nul) - r.p;
+			s.assign(reinterpret_cast<const char*>(r.p), len);
+			r.p += len + 1; r.left -= len + 1;
+			return true;
+		}
+	};
+
+	/* NUL terminated but sized by its extent, may hold NULs of its own (binary payloads) */
+	struct SizedCStr
+	{
+		using type = std::string;
+		using decoded = std::string;
+		static constexpr size_t minSize = 1;
+		static size_t size(const std::string& s) { return s.size() + 1; }
+		static void put(unsigned char*& p, const std::string& s) { CStr::put(p, s); }
+		static bool get(ByteReader& r, std::string& s) {
+			if (r.left == 0 || r.p[r.left - 1] != 0) return false;
+			s.assign(reinterpret_cast<const char*>(r.p), r.left - 1);
+			r.p += r.left; r.left = 0;
+			return true;
+		}
+	};
+
+	/* Length prefixed, L wide */
+	template<class L> struct LenStr
+	{
+		using type = std::string;
+		using decoded = std::string;
+		static constexpr size_t minSize = sizeof(L);
+		static size_t size(const std::string& s) { return sizeof(L) + s.size(); }
+		static void put(unsigned char*& p, const std::string& s) {
+			const L n = static_cast<L>(s.size());
+			std::memcpy(p, &n, sizeof(L)); p += sizeof(L);
+			std::memcpy(p, s.data(), s.size()); p += s.size();
+		}
+		static bool get(ByteReader& r, std::string& s) {
+			L n = 0;
+			if (!r.read(&n, sizeof(L)) || static_cast<size_t>(n) > r.left) return false;
+			s.assign(reinterpret_cast<const char*>(r.p), static_cast<size_t>(n));
+			r.p += n; r.left -= n;
+			return true;
+		}
+	};
+
+	/* Raw bytes, sized by the field's extent */
+	struct Bytes
+	{
+		using type = std::vector<unsigned char>;
+		using decoded = std::vector<unsigned char>;
+		static constexpr size_t minSize = 0;
+		static size_t size(const type& v) { return v.size(); }
+		static void put(unsigned char*& p, const type& v) { if (!v.empty()) std::memcpy(p, v.data(), v.size()); p += v.size(); }
+		static bool get(ByteReader& r, type& v) { v.assign(r.p, r.p + r.left); r.p += r.left; r.left = 0; return true; }
+	};
+
+	/* DER public key sized by the field's extent, a null key is no bytes */
+	struct Der
+	{
+		using type = EVP_PKEY_ptr;
+		using decoded = EVP_PKEY_ptr;
+		static constexpr size_t minSize = 0;
+		static size_t size(const EVP_PKEY_ptr& k) {
+			const int n = k ? i2d_PUBKEY(k.get(), nullptr) : 0;
+			return n > 0 ? static_cast<size_t>(n) : 0;
+		}
+		static void put(unsigned char*& p, const EVP_PKEY_ptr& k) { if (k) i2d_PUBKEY(k.get(), &p); }
+		static bool get(ByteReader& r, EVP_PKEY_ptr& k) {
+			k = nullptr;
+			if (r.left == 0) return true;
+			const unsigned char* q = r.p;
+			EVP_PKEY* raw = d2i_PUBKEY(nullptr, &q, static_cast<long>(r.left));
+			if (raw == nullptr) return false;
+			k = EVP_PKEY_ptr(raw, EVP_PKEY_Deleter());
+			const size_t used = q - r.p;
+			r.p = q; r.left -= used;
+			return true;
+		}
+	};
+
+	/* A type with its own size prefixed encoding (getSize, serializeTo), decoded as a view */
+	template<class T> struct Framed
+	{
+		using type = T;
+		using decoded = std::span<const uint8_t>;
+		static constexpr size_t minSize = sizeof(size_t);
+		static size_t size(const T& v) { return v.getSize(); }
+		static void put(unsigned char*& p, const T& v) { v.serializeTo(p); p += v.getSize(); }
+		static bool get(ByteReader& r, decoded& v) {
+			const unsigned char* start = nullptr;
+			size_t n = 0;
+			if (!r.view(start, n)) return false;
+			v = decoded(start, n);
+			return true;
+		}
+	};
+
+	template<class... C> struct Tuple
+	{
+		using type = std::tuple<typename C::type...>;
+		using decoded = std::tuple<typename C::decoded...>;
+		static constexpr size_t minSize = (C::minSize + ... + 0);
+		static size_t size(const type& v) {
+			return std::apply([](const auto&... e) { return (C::size(e) + ... + 0); }, v);
+		}
+		static void put(unsigned char*& p, const type& v) {
+			std::apply([&p](const auto&... e) { (C::put(p, e), ...); }, v);
+		}
+		static bool get(ByteReader& r, decoded& v) {
+			return std::apply([&r](auto&... e) { return (C::get(r, e) && ...); }, v);
+		}
+	};
+
+	template<class C> struct Seq
+	{
+		using type = std::vector<typename C::type>;
+		using decoded = std::vector<typename C::decoded>;
+		static constexpr size_t minSize = 0;
+		static constexpr bool flat = std::is_same_v<C, Raw<typename C::type>>;
+
+		static size_t size(const type& v) {
+			if constexpr (flat) {
+				return v.size() * sizeof(typename C::type);
+			}
+			else {
+				size_t n = 0;
+				for (const auto& e : v) n += C::size(e);
+				return n;
+			}
+		}
+		static void put(unsigned char*& p, const type& v) {
+			if constexpr (flat) {
+				if (!v.empty()) std::memcpy(p, v.data(), size(v));
+				p += size(v);
+			}
+			else {
+				for (const auto& e : v) C::put(p, e);
+			}
+		}
+		/* count elements, or up to the end of the extent when there is no Count field */
+		static bool get(ByteReader& r, decoded& v, const size_t count) {
+			v.clear();
+			if (count == UNSET) {
+				while (r.left > 0) {
+					if (!C::get(r, v.emplace_back())) return false;
+				}
+				return true;
+			}
+			if (count > r.left / std::max<size_t>(C::minSize, 1)) return false;
+			if constexpr (flat) {
+				v.resize(count);
+				return r.read(v.data(), count * sizeof(typename C::type));
+			}
+			else {
+				v.resize(count);
+				for (auto& e : v) {
+					if (!C::get(r, e)) return false;
+				}
+				return true;
+			}
+		}
+	};
+
+	/* Codec picked from the member type */
+	template<class T> struct Auto { using type = Raw<T>; };
+	template<> struct Auto<Address> { using type = Addr; };
+	template<> struct Auto<std::string> { using type = CStr; };
+	template<> struct Auto<std::vector<unsigned char>> { using type = Bytes; };
+	template<> struct Auto<EVP_PKEY_ptr> { using type = Der; };
+	template<class E> struct Auto<std::vector<E>> { using type = Seq<typename Auto<E>::type>; };
+	template<class... E> struct Auto<std::tuple<E...>> { using type = Tuple<typename Auto<E>::type...>; };
+
+	struct PickAuto {};
+
+	/*-- Field kinds --*/
+
+	template<class C, auto... P> struct FieldAs { using path = Path<P...>; using codec = C; };
+	template<class N, auto... P> struct CountOf { using path = Path<P...>; using width = N; };
+	template<class N, auto... P> struct ExtentOf { using path = Path<P...>; using width = N; };
+
+	template<auto... P> using Field = FieldAs<PickAuto, P...>;
+	template<auto... P> using Count = CountOf<size_t, P...>;
+	template<auto... P> using Extent = ExtentOf<size_t, P...>;
+
+	template<class F> struct isField : std::false_type {};
+	template<class C, auto... P> struct isField<FieldAs<C, P...>> : std::true_type {};
+	template<class F> struct isCount : std::false_type {};
+	template<class N, auto... P> struct isCount<CountOf<N, P...>> : std::true_type {};
+
+	template<class T, class Pth> struct Member;
+	template<class T, auto... P> struct Member<T, Path<P...>> {
+		using type = std::remove_cvref_t<decltype(walk<P...>(std::declval<const T&>()))>;
+		static const type& of(const T& obj) { return walk<P...>(obj); }
+	};
+
+	template<class T, class... Fs> class Layout
+	{
+		template<class F> using member = Member<T, typename F::path>;
+
+		template<class F> struct codecOf { using type = void; };
+		template<class C, auto... P> struct codecOf<FieldAs<C, P...>> {
+			using type = std::conditional_t<std::is_same_v<C, PickAuto>,
+				typename Auto<typename Member<T, Path<P...>>::type>::type, C>;
+		};
+		template<class F> using codec = typename codecOf<F>::type;
+
+		/* Decoded slot of each field, counts & extents take none */
+		template<class F> struct slotOf { using type = std::monostate; };
+		template<class C, auto... P> struct slotOf<FieldAs<C, P...>> { using type = typename codec<FieldAs<C, P...>>::decoded; };
+
+		static constexpr size_t N = sizeof...(Fs);
+
+		/* Index of the Field a count/extent/lookup names */
+		template<class Pth> static constexpr size_t fieldIndex() {
+			constexpr bool hits[] = { (isField<Fs>::value && std::is_same_v<typename Fs::path, Pth>)... };
+			for (size_t i = 0; i < N; i++) {
+				if (hits[i]) return i;
+			}
+			return N;
+		}
+
+	public:
+		struct Decoded
+		{
+			std::tuple<typename slotOf<Fs>::type...> values;
+			std::array<size_t, N> counts;
+			std::array<size_t, N> extents;
+		};
+
+		/* Exact encoded size, prefix included */
+		static size_t size(const T& obj) {
+			return sizeof(size_t) + (fieldSize<Fs>(obj) + ... + 0);
+		}
+
+		/* Writes size(obj) bytes at out */
+		static void write(const T& obj, unsigned char* out) {
+			const size_t tSize = size(obj);
+			unsigned char* p = out;
+			std::memcpy(p, &tSize, sizeof(size_t));
+			p += sizeof(size_t);
+			(put<Fs>(obj, p), ...);
+		}
+
+		static std::unique_ptr<unsigned char[]> encode(const T& obj) {
+			std::unique_ptr<unsigned char[]> out(new unsigned char[size(obj)]);
+			write(obj, out.get());
+			return out;
+		}
+
+		/* Bytes past the size prefix are left alone, they belong to whatever follows */
+		static bool decode(const std::span<const uint8_t> in, Decoded& d) {
+			size_t tSize = 0;
+			if (in.size() < sizeof(size_t)) return false;
+			std::memcpy(&tSize, in.data(), sizeof(size_t));
+			if (tSize < sizeof(size_t) || tSize > in.size()) return false;
+
+			ByteReader r{in.data() + sizeof(size_t), tSize - sizeof(size_t)};
+			d.counts.fill(UNSET);
+			d.extents.fill(UNSET);
+			return decodeAll(r, d, std::make_index_sequence<N>{}) && r.left == 0;
+		}
+
+		/* For a buffer allocated at its own size prefix */
+		static bool decode(const std::unique_ptr<unsigned char[]>& buffer, Decoded& d) {
+			if (!buffer) return false;
+			size_t tSize = 0;
+			std::memcpy(&tSize, buffer.get(), sizeof(size_t));
+			return decode(std::span<const uint8_t>(buffer.get(), tSize), d);
+		}
+
+		/* Byte size a decoded field's Extent gave, UNSET if it has none */
+		template<auto... P> static size_t extentOf(const Decoded& d) {
+			return d.extents[fieldIndex<Path<P...>>()];
+		}
+
+		template<auto... P> static auto& at(Decoded& d) {
+			constexpr size_t i = fieldIndex<Path<P...>>();
+			static_assert(i < N, "no Field with this path");
+			return std::get<i>(d.values);
+		}
+
+	private:
+		template<class F> static size_t fieldSize(const T& obj) {
+			if constexpr (isField<F>::value) {
+				return codec<F>::size(member<F>::of(obj));
+			}
+			else {
+				return sizeof(typename F::width);
+			}
+		}
+
+		template<class F> static void put(const T& obj, unsigned char*& p) {
+			if constexpr (isField<F>::value) {
+				codec<F>::put(p, member<F>::of(obj));
+			}
+			else {
+				constexpr size_t target = fieldIndex<typename F::path>();
+				static_assert(target < N, "count/extent of a path with no Field");
+				using Target = std::tuple_element_t<target, std::tuple<Fs...>>;
+				const auto& m = member<Target>::of(obj);
+				const auto n = static_cast<typename F::width>(isCount<F>::value ? sizeOf(m) : codec<Target>::size(m));
+				std::memcpy(p, &n, sizeof(n));
+				p += sizeof(n);
+			}
+		}
+
+		template<class M> static size_t sizeOf(const M& m) {
+			if constexpr (requires { m.size(); }) return m.size();
+			else return 1;
+		}
+
+		template<size_t... I> static bool decodeAll(ByteReader& r, Decoded& d, std::index_sequence<I...>) {
+			return (get<I>(r, d) && ...);
+		}
+
+		template<size_t I> static bool get(ByteReader& r, Decoded& d) {
+			using F = std::tuple_element_t<I, std::tuple<Fs...>>;
+			if constexpr (isField<F>::value) {
+				using C = codec<F>;
+				auto& v = std::get<I>(d.values);
+				const size_t extent = d.extents[I];
+				ByteReader sub = r;
+				if (extent != UNSET) {
+					if (extent > r.left) return false;
+					sub.left = extent;
+				}
+				bool ok = false;
+				if constexpr (requires { C::get(sub, v, size_t{}); }) ok = C::get(sub, v, d.counts[I]);
+				else ok = C::get(sub, v);
+				if (!ok || (extent != UNSET && sub.left != 0)) return false;
+				const size_t used = sub.p - r.p;
+				r.p += used; r.left -= used;
+				return true;
+			}
+			else {
+				typename F::width n{};
+				if (!r.read(&n, sizeof(n))) return false;
+				if constexpr (std::is_signed_v<typename F::width>) {
+					if (n < 0) return false;
+				}
+				constexpr size_t target = fieldIndex<typename F::path>();
+				(isCount<F>::value ? d.counts : d.extents)[target] = static_cast<size_t>(n);
+				return true;
+			}
+		}
+	};
+}
+
+#endif
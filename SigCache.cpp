@@ -0,0 +1,63 @@
+/*-- SigCache.cpp -------------------------------------------------------------
+   This file implements the verified signature cache member functions.
+-----------------------------------------------------------------------------*/
+#include "SigCache.h"
+
+SigCache::SigCache(const std::string& saltPath) {
+    /* Reuse the node salt so digests survive restarts */
+    std::ifstream in(saltPath, std::ios::binary);
+    if (in.read(reinterpret_cast<char*>(salt.data()), SALT_SIZE) && in.gcount() == SALT_SIZE) {
+        util::logCall("SIGCACHE", "SigCache()", true);
+        return;
+    }
+
+    if (RAND_bytes(salt.data(), SALT_SIZE) != 1) {
+        util::logCall("SIGCACHE", "SigCache()", false, "RAND_bytes Failed");
+    }
+    std::ofstream out(saltPath, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char*>(salt.data()), SALT_SIZE)) {
+        util::logCall("SIGCACHE", "SigCache()", false, "Salt Not Saved");
+        return;
+    }
+    util::logCall("SIGCACHE", "SigCache()", true);
+}
+
+std::vector<unsigned char> SigCache::digest(const utxout& uin) const {
+    std::string msg(reinterpret_cast<const char*>(salt.data()), SALT_SIZE);
+    msg.append(uin.utxo);
+    msg.append(uin.utxoSignedHash.begin(), uin.utxoSignedHash.end());
+
+    /* Public key in DER form */
+    unsigned char* der = nullptr;
+    const int len = uin.pubkey ? i2d_PUBKEY(uin.pubkey.get(), &der) : 0;
+    if (len > 0) {
+        msg.append(reinterpret_cast<const char*>(der), len);
+        OPENSSL_free(der);
+    }
+
+    std::vector<unsigned char> hash;
+    if (!util::shaHash(msg, hash)) {
+        util::logCall("SIGCACHE", "digest()", false, "Hash Failed");
+        return {};
+    }
+    return hash;
+}
+
+bool SigCache::contains(const std::vector<unsigned char>& d) const {
+    if (d.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    return digests.contains(std::string(d.begin(), d.end()));
+}
+
+void SigCache::insert(const std::vector<unsigned char>& d) {
+    if (d.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (digests.size() >= MAX_ENTRIES) {
+        digests.clear(); // bounded, a miss only costs a re-verification
+    }
+    digests.emplace(d.begin(), d.end());
+}
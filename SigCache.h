@@ -0,0 +1,45 @@
+#ifndef SIGCACHE
+#define SIGCACHE
+
+#include "util.h"
+#include "Wallet.h"
+#include <mutex>
+#include <unordered_set>
+
+/*-- SigCache.h ---------------------------------------------------------------
+
+  This header file defines the cache of transaction signatures this node
+  has already verified. An entry is a salted digest of the signed tx,
+  its signature and the signer's public key, so a tx seen again (gossip,
+  mempool reload) skips the ECDSA verification.
+
+  Basic operations are:
+	 digest:    Salted SHA3-512 of tx bytes || signature || public key
+	 contains:  True if the digest was verified by this node
+	 insert:    Records a digest after a successful verification
+
+Note:
+  The salt is created once per node and kept in saltPath. Digests written
+  to disk (mempool dumps) are only trusted if they match this salt, so a
+  dump from another node, or one edited by hand, is fully re-verified.
+-------------------------------------------------------------------------*/
+
+class SigCache
+{
+public:
+	static constexpr size_t SALT_SIZE = 32;
+	static constexpr size_t MAX_ENTRIES = 100000;
+
+	explicit SigCache(const std::string& saltPath = "sigcache.salt");
+
+	std::vector<unsigned char> digest(const utxout& uin) const;
+	bool contains(const std::vector<unsigned char>& d) const;
+	void insert(const std::vector<unsigned char>& d);
+
+private:
+	std::array<unsigned char, SALT_SIZE> salt{};
+	mutable std::mutex mtx;
+	std::unordered_set<std::string> digests;
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*-- Snapshot.cpp -------------------------------------------------------------
+   This file implements state snapshot encoding, digest & file storage.
+-----------------------------------------------------------------------------*/
+#include "Snapshot.h"
+#include "ByteIO.h"
+#include <cstdio>
+
+namespace {
+    constexpr size_t txidSize = 32;
+    constexpr size_t maxHashSize = 256;
+    constexpr size_t maxIdSize = 4096;
+
+    void putString(ByteWriter& w, const std::string& s) {
+        w.bytes(std::vector<unsigned char>(s.begin(), s.end()));
+    }
+
+    bool readString(ByteReader& r, std::string& s) {
+        std::vector<unsigned char> v;
+        if (!r.bytes(v, maxIdSize)) return false;
+        s.assign(v.begin(), v.end());
+        return true;
+    }
+
+    /* Every list entry takes at least one byte, so a count larger than what is left is a lie */
+    bool readCount(ByteReader& r, size_t& n) {
+        return r.read(&n, sizeof(size_t)) && n <= r.left;
+    }
+}
+
+void Snapshot::writeCommitted(std::vector<unsigned char>& out) const {
+    ByteWriter w;
+    w.put(&FORMAT_VERSION, sizeof(FORMAT_VERSION));
+    w.put(&height, sizeof(height));
+    w.bytes(anchor);
+    w.put(&chainVersion, sizeof(chainVersion));
+    w.put(&conf, sizeof(conf));
+    w.put(&minted, sizeof(minted));
+
+    const size_t nBal = balances.size();
+    w.put(&nBal, sizeof(size_t));
+    for (const auto& [addr, value] : balances) {
+        w.put(addr.bytes.data(), Address::SIZE);
+        w.put(&value, sizeof(Amount));
+    }
+
+    const size_t nTx = txids.size();
+    w.put(&nTx, sizeof(size_t));
+    for (const auto& [id, h] : txids) {
+        std::vector<unsigned char> raw;
+        if (!util::fromHex(id, raw) || raw.size() != txidSize) {
+            raw.assign(txidSize, 0);
+        }
+        w.put(raw.data(), txidSize);
+        w.put(&h, sizeof(h));
+    }
+    out = std::move(w.body);
+}
+
+std::vector<unsigned char> Snapshot::digest() const {
+    std::vector<unsigned char> committed;
+    writeCommitted(committed);
+    std::vector<unsigned char> hash;
+    if (!util::shaHash(std::string(committed.begin(), committed.end()), hash)) {
+        util::logCall("SNAPSHOT", "digest()", false, "Hash Failed");
+        return {};
+    }
+    return hash;
+}
+
+std::unique_ptr<unsigned char[]> Snapshot::serialize() const {
+    /* Layout: tSize | committed section | totalSupply | circSupply | delegates | delegate IDs | votes */
+    ByteWriter w;
+    writeCommitted(w.body);
+    w.put(&totalSupply, sizeof(Amount));
+    w.put(&circSupply, sizeof(Amount));
+
+    const size_t nDel = delegates.size();
+    w.put(&nDel, sizeof(size_t));
+    for (const auto& d : delegates) putString(w, d);
+
+    const size_t nIds = delegateIDs.size();
+    w.put(&nIds, sizeof(size_t));
+    for (const auto& id : delegateIDs) putString(w, id);
+
+    const size_t nVotes = votes.size();
+    w.put(&nVotes, sizeof(size_t));
+    for (const auto& [voter, del, weight] : votes) {
+        w.put(voter.bytes.data(), Address::SIZE);
+        putString(w, del);
+        w.put(&weight, sizeof(float));
+    }
+    return w.finish();
+}
+
+bool Snapshot::deserialize(const std::unique_ptr<unsigned char[]>& buffer, Snapshot& out) {
+    ByteReader r;
+    uint32_t format = 0;
+    size_t n = 0;
+    auto fail = [](const char* why) {
+        util::logCall("SNAPSHOT", "deserialize()", false, why);
+        return false;
+    };
+
+    if (!r.open(buffer) || !r.read(&format, sizeof(format)) || format != FORMAT_VERSION) {
+        return fail("Unknown Snapshot Format");
+    }
+    if (!r.read(&out.height, sizeof(out.height)) || !r.bytes(out.anchor, maxHashSize)
+        || !r.read(&out.chainVersion, sizeof(out.chainVersion)) || !r.read(&out.conf, sizeof(out.conf))
+        || !r.read(&out.minted, sizeof(out.minted)) || !readCount(r, n)) {
+        return fail("Malformed Header");
+    }
+
+    out.balances.clear();
+    out.balances.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        Address a;
+        Amount v = 0;
+        if (!r.read(a.bytes.data(), Address::SIZE) || !r.read(&v, sizeof(Amount)) || !Amounts::inRange(v)) {
+            return fail("Malformed Balances");
+        }
+        out.balances.emplace_back(a, v);
+    }
+
+    if (!readCount(r, n)) {
+        return fail("Malformed Txids");
+    }
+    out.txids.clear();
+    out.txids.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        unsigned char raw[txidSize];
+        unsigned int h = 0;
+        if (!r.read(raw, txidSize) || !r.read(&h, sizeof(h))) {
+            return fail("Malformed Txids");
+        }
+        out.txids.emplace_back(util::toHex(raw, txidSize), h);
+    }
+
+    if (!r.read(&out.totalSupply, sizeof(Amount)) || !r.read(&out.circSupply, sizeof(Amount)) || !readCount(r, n)) {
+        return fail("Malformed Supply");
+    }
+    out.delegates.assign(n, {});
+    for (auto& d : out.delegates) {
+        if (!readString(r, d)) return fail("Malformed Delegates");
+    }
+    if (!readCount(r, n)) {
+        return fail("Malformed Delegate IDs");
+    }
+    out.delegateIDs.assign(n, {});
+    for (auto& id : out.delegateIDs) {
+        if (!readString(r, id)) return fail("Malformed Delegate IDs");
+    }
+    if (!readCount(r, n)) {
+        return fail("Malformed Votes");
+    }
+    out.votes.clear();
+    for (size_t i = 0; i < n; i++) {
+        Address voter;
+        std::string del;
+        float weight = 0;
+        if (!r.read(voter.bytes.data(), Address::SIZE) || !readString(r, del) || !r.read(&weight, sizeof(float))) {
+            return fail("Malformed Votes");
+        }
+        out.votes.emplace_back(voter, std::move(del), weight);
+    }
+    return r.left == 0 ? true : fail("Trailing Bytes");
+}
+
+bool Snapshot::save(const std::string& path) const {
+    const std::unique_ptr<unsigned char[]> buf = serialize();
+    size_t tSize = 0;
+    std::memcpy(&tSize, buf.get(), sizeof(size_t));
+
+    /* Written aside & renamed, a crash never leaves a half snapshot */
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(buf.get()), static_cast<std::streamsize>(tSize));
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        util::logCall("SNAPSHOT", "save()", false, "Write Failed");
+        return false;
+    }
+    util::logCall("SNAPSHOT", "save()", true);
+    return true;
+}
+
+bool Snapshot::load(const std::string& path, Snapshot& out) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    const std::streamsize size = in.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(size_t))) {
+        util::logCall("SNAPSHOT", "load()", false, "Truncated Snapshot");
+        return false;
+    }
+    std::unique_ptr<unsigned char[]> buf(new unsigned char[size]);
+    in.seekg(0);
+    size_t tSize = 0;
+    if (!in.read(reinterpret_cast<char*>(buf.get()), size)
+        || (std::memcpy(&tSize, buf.get(), sizeof(size_t)), tSize != static_cast<size_t>(size))) {
+        util::logCall("SNAPSHOT", "load()", false, "Truncated Snapshot");
+        return false;
+    }
+    return deserialize(buf, out);
+}
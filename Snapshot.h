@@ -0,0 +1,75 @@
+#ifndef SNAPSHOT
+#define SNAPSHOT
+
+#include "util.h"
+#include "Address.h"
+#include "Amount.h"
+
+/*-- Snapshot.h ---------------------------------------------------------------
+
+  This header file defines the state snapshot a joining node can start
+  from instead of replaying the whole chain. A snapshot holds the state
+  once every block up to `height` is confirmed:
+
+	 Committed (chain derived, identical on every node):
+	   height, anchor (hash of the block at height), chain info,
+	   confirmed address balances, every txid up to height (replay
+	   protection) & the amount minted by coinbases
+	 Node local (also fed by gossip, not committed):
+	   Coin supply, delegate schedule, delegate IDs & vote tally. A
+	   joining node cannot verify these, so they are written empty and
+	   never restored; the section stays for format compatibility
+
+  The producer of the first block after `height` is confirmed puts
+  digest() into that block's head, and every node checks it against
+  its own state when linking the block. A fast syncing node trusts a
+  snapshot only if its digest equals one committed in the header chain.
+
+  Basic operations are:
+	 digest:       SHA3-512 of the committed section
+	 serialize:    Wire & file form, deserialize bounds checks it
+	 save / load:  Snapshot file
+
+Note:
+  Snapshots are taken every INTERVAL confirmed heights, at that exact
+  height (rebuilt through the chain's undo records when one confirmation
+  crossed it). Balances are
+  kept sorted by address & txids by txid so the digest is canonical.
+-------------------------------------------------------------------------*/
+
+class Snapshot
+{
+public:
+	static constexpr unsigned int INTERVAL = 1000;
+	static constexpr uint32_t FORMAT_VERSION = 1;
+
+	/* Committed */
+	unsigned int height = 0;
+	std::vector<unsigned char> anchor;
+	float chainVersion = 0;
+	unsigned short conf = 0;
+	std::vector<std::pair<Address, Amount>> balances;
+	std::vector<std::pair<std::string, unsigned int>> txids; // txid -> height
+	Amount minted = 0;
+
+	/* Node local */
+	Amount totalSupply = 0;
+	Amount circSupply = 0;
+	std::vector<std::string> delegates;
+	std::vector<std::string> delegateIDs;
+	std::vector<std::tuple<Address, std::string, float>> votes;
+
+	std::vector<unsigned char> digest() const;
+
+	std::unique_ptr<unsigned char[]> serialize() const;
+	static bool deserialize(const std::unique_ptr<unsigned char[]>& buffer, Snapshot& out);
+
+	bool save(const std::string& path) const;
+	static bool load(const std::string& path, Snapshot& out);
+
+private:
+	/* Canonical encoding of the committed section */
+	void writeCommitted(std::vector<unsigned char>& out) const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef UNDO
+#define UNDO
+
+#include "Address.h"
+#include "Amount.h"
+#include "Interner.h"
+#include "UtxoSet.h"
+#include "Wallet.h"
+
+/*-- Undo.h -------------------------------------------------------------------
+
+  This header file defines the undo records kept for recent blocks, so a
+  reorg takes a block off by reverting exactly what it changed instead of
+  rebuilding the state from genesis. Disconnecting costs what the block
+  touched, nothing more.
+
+	 ChainUndo:  What confirming the block changed in the chain's balance
+	             index, kept by BlockChain per confirmed height
+	 NodeUndo:   What the block changed in this node: wallet outputs and
+	             consensus updates from confirm(), supply added by its
+	             reward when this node produced it, signed txs it took
+	             out of the mempool; kept by Peer
+
+Note:
+  Records are kept by height for the last BlockChain::UNDO_DEPTH
+  confirmed blocks (heights on the main chain are unique). A block with
+  no record left can no longer be disconnected, that bounds reorgs.
+-------------------------------------------------------------------------*/
+
+struct ChainUndo
+{
+	/* Balance of every address the block touched before it was applied, 0 = absent */
+	std::vector<std::pair<Address, Amount>> priorBalances;
+	Amount minted = 0; // coinbase outputs
+};
+
+struct NodeUndo
+{
+	std::vector<OutPoint> walletOutputs; // outputs credited to this wallet
+	bool delegatesSet = false;
+	std::vector<std::string> priorDelegates; // schedule replaced by the block, if delegatesSet
+	std::vector<std::string> addedDelegateIDs; // ids first learned from the block
+	std::vector<std::tuple<Address, IdHandle, float>> votes; // votes the block applied
+	Amount supplyAdded = 0; // reward counted into Coin supply
+	std::vector<utxout> pooled; // signed txs linking it took out of the mempool, offered again if it is disconnected
+};
+
+#endif
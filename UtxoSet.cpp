@@ -0,0 +1,63 @@
+/*-- UtxoSet.cpp --------------------------------------------------------------
+   This file implements the wallet UTXO set member functions.
+-----------------------------------------------------------------------------*/
+#include "UtxoSet.h"
+
+bool UtxoSet::add(const OutPoint& out, const Amount value) {
+    Amount newTotal = 0;
+    if (value <= 0 || !Amounts::add(total, value, newTotal)) {
+        util::logCall("UTXOSET", "add()", false, "Amount Out Of Range");
+        return false;
+    }
+
+    const auto [it, inserted] = entries.try_emplace(out, UtxoEntry{value, nextSeq});
+    if (!inserted) {
+        return false; // already known, e.g. a block confirmed twice
+    }
+
+    byAge.emplace(nextSeq, out);
+    byValue.emplace(value, nextSeq);
+    nextSeq++;
+    total = newTotal;
+    return true;
+}
+
+bool UtxoSet::spend(const OutPoint& out, Amount& value) {
+    const auto it = entries.find(out);
+    if (it == entries.end()) {
+        util::logCall("UTXOSET", "spend()", false, "Unknown Outpoint");
+        return false;
+    }
+
+    value = it->second.value;
+    byAge.erase(it->second.seq);
+    byValue.erase({value, it->second.seq});
+    entries.erase(it);
+    total -= value;
+    return true;
+}
+
+bool UtxoSet::contains(const OutPoint& out) const {
+    return entries.contains(out);
+}
+
+Amount UtxoSet::balance() const {
+    return total;
+}
+
+size_t UtxoSet::size() const {
+    return entries.size();
+}
+
+bool UtxoSet::empty() const {
+    return entries.empty();
+}
+
+std::vector<std::pair<OutPoint, Amount>> UtxoSet::list() const {
+    std::vector<std::pair<OutPoint, Amount>> out;
+    out.reserve(byAge.size());
+    for (const auto& [seq, op] : byAge) {
+        out.emplace_back(op, entries.find(op)->second.value);
+    }
+    return out;
+}
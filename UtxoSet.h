@@ -0,0 +1,97 @@
+#ifndef UTXOSET
+#define UTXOSET
+
+#include "util.h"
+#include "Amount.h"
+#include <map>
+#include <set>
+#include <unordered_map>
+
+/*-- UtxoSet.h ----------------------------------------------------------------
+
+  This header file defines the indexed set of unspent outputs owned by a
+  Wallet. Every output is keyed by its outpoint (txid, output index) and
+  the set keeps a running balance, so adding, spending and asking for the
+  balance never walk the whole wallet.
+
+  Basic operations are:
+	 add:       Inserts an unspent output, duplicates are ignored
+	 spend:     Removes an output and returns its value
+	 visitByAge / visitByValue:  Ordered walks that stop as soon as the
+	            visitor returns false, used by the coin selectors
+	 balance:   Running total of every unspent output
+
+Note:
+  Outputs also sit in an age index (insertion sequence) and a value
+  index, so a selector only visits the outputs it actually considers.
+  Selection strategies live in CoinSelection.h.
+-------------------------------------------------------------------------*/
+
+/* Reference to one output of a transaction */
+struct OutPoint
+{
+	std::string txid;
+	uint32_t index = 0;
+
+	bool operator==(const OutPoint& other) const = default;
+};
+
+struct OutPointHash
+{
+	size_t operator()(const OutPoint& o) const noexcept {
+		return std::hash<std::string>{}(o.txid) ^ (static_cast<size_t>(o.index) * 0x9e3779b97f4a7c15ULL);
+	}
+};
+
+/* Value & position of an unspent output */
+struct UtxoEntry { Amount value = 0; uint64_t seq = 0; };
+
+class UtxoSet
+{
+public:
+	/* Add an unspent output, false if already present or out of range */
+	bool add(const OutPoint& out, Amount value);
+
+	/* Remove an unspent output, false if unknown */
+	bool spend(const OutPoint& out, Amount& value);
+
+	bool contains(const OutPoint& out) const;
+
+	/* Ordered walks, visitor(const OutPoint&, Amount) returns false to stop */
+	template <typename Visitor>
+	void visitByAge(Visitor&& visit) const {
+		for (const auto& [seq, out] : byAge) {
+			if (!visit(out, entries.find(out)->second.value)) return;
+		}
+	}
+
+	template <typename Visitor>
+	void visitByValue(const bool largestFirst, Visitor&& visit) const {
+		if (largestFirst) {
+			for (auto it = byValue.rbegin(); it != byValue.rend(); ++it) {
+				if (!visit(byAge.find(it->second)->second, it->first)) return;
+			}
+		}
+		else {
+			for (const auto& [value, seq] : byValue) {
+				if (!visit(byAge.find(seq)->second, value)) return;
+			}
+		}
+	}
+
+	Amount balance() const;
+	size_t size() const;
+	bool empty() const;
+
+	/* Ordered (oldest-first) view for listing */
+	std::vector<std::pair<OutPoint, Amount>> list() const;
+
+private:
+	std::unordered_map<OutPoint, UtxoEntry, OutPointHash> entries;
+	std::map<uint64_t, OutPoint> byAge;
+	std::set<std::pair<Amount, uint64_t>> byValue;
+	Amount total = 0;
+	uint64_t nextSeq = 0;
+};
+
+#endif
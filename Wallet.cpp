@@ -12,7 +12,6 @@ Wallet::Wallet()
     versionUTXO = 1.0;
     address = genAddress();
     txCount = 0;
-    balance = 0;
     util::logCall("WALLET", "Wallet()", true);
 }
 
@@ -146,7 +145,7 @@ EVP_PKEY_ptr Wallet::extract_public_key(){
     return temp;
 }
 
-std::string Wallet::genAddress() const {
+Address Wallet::genAddress() const {
     // Get DER and create buffer
     unsigned char* temp = nullptr;  // Use temp for i2d_PUBKEY to advance
     int len = i2d_PUBKEY(pubKeyP.get(), &temp);
@@ -158,13 +157,12 @@ std::string Wallet::genAddress() const {
         std::vector<unsigned char> ripe;
         if (util::ripemd(md, ripe)) {
 
-            /* Base 58 Encode */
-            const std::string output = util::base58_encode(ripe.data(), ripe.size());
-            std::string addr = "Ox17" + output;
+            /* Binary address is the RIPEMD-160 digest itself */
+            Address addr(ripe.data());
             OPENSSL_free(temp);
 
-            /* Return Address */
-            std::cout << "Wallet Address: " << addr << std::endl;
+            /* Return Address (Base58Check only for display) */
+            std::cout << "Wallet Address: " << addr.toString() << std::endl;
             util::logCall("WALLET", "genAddress()", true);
             return addr;
         }
@@ -179,35 +177,47 @@ std::string Wallet::genAddress() const {
     }
 
     util::logCall("WALLET", "genAddress()", false, "RIPEMD failed!");
-    return "";
+    return {};
 }
 
-utxout Wallet::outUTXO(double feee, const std::vector<std::string>& rwa, const std::vector<double>& amm, const std::vector<std::string> &delegates,
-    const std::vector<std::string> &delegateID, const std::vector<std::tuple<std::string, std::string, float>> &votesQueue) {
+utxout Wallet::outUTXO(Amount feee, const std::vector<Address>& rwa, const std::vector<Amount>& amm, const std::vector<std::string> &delegates,
+    const std::vector<std::string> &delegateID, const std::vector<std::tuple<Address, std::string, float>> &votesQueue) {
     /* Structure UTXO */
-    transactions utxo(address, rwa, amm, feee, locktimeUTXO, versionUTXO, delegates, delegateID, votesQueue);
+    std::optional<transactions> utxo;
+    utxo.emplace(address, rwa, amm, feee, locktimeUTXO, versionUTXO, delegates, delegateID, votesQueue);
 
     /* Check for balance */
-    setBalance();
-    double bal = getBalance();
-    double check = 0;
-    std::vector<double> checkbal = utxo.getAmmount();
-    for (double amount : checkbal) {
-        check += amount;
+    Amount bal = getBalance();
+    Amount check = 0;
+    if (!utxo->totalAmm(check) || !Amounts::add(check, feee, check)) {
+        util::logCall("WALLET", "outUTXO()", false, "Amount Out Of Range");
+        std::cout << "Amount Out Of Range!\n";
+        return {};
     }
-    check += feee;
 
-    if (check > bal) {
+    CoinPick picked;
+    if (check > bal || !selector->select(utxos, check, picked)) {
         util::logCall("WALLET", "outUTXO()", false, "Amount Exceeds Balance");
         std::cout << "Amount Exceeds Balance!\n";
         return {};
     }
 
+    /* An excess inside the selector's change window goes to the fee, the spend then mints no change */
+    Amount excess = -check;
+    for (const auto& [op, value] : picked) {
+        excess += value; // bounded by the wallet balance, cannot overflow
+    }
+    if (excess > 0 && excess <= selector->changeWindow()) {
+        feee += excess;
+        check += excess;
+        utxo.emplace(address, rwa, amm, feee, locktimeUTXO, versionUTXO, delegates, delegateID, votesQueue);
+    }
+
     /* Sign UTXO */
     utxout out;
     std::vector<unsigned char> hash;
     std::vector<unsigned char> sig;
-    std::unique_ptr<unsigned char[]> temp = utxo.serialize();
+    std::unique_ptr<unsigned char[]> temp = utxo->serialize();
     size_t utxSize = 0; std::memcpy(&utxSize, temp.get(), sizeof(size_t));
     std::string msg; msg.resize(utxSize);
     msg.assign(reinterpret_cast<const char*>(temp.get()), utxSize);
@@ -216,9 +226,9 @@ utxout Wallet::outUTXO(double feee, const std::vector<std::string>& rwa, const s
         if (ecDoSign(hash, sig)) {
             /* Setup tx & Signed Message for mempool */
             size_t testsz = 0;
-            std::unique_ptr<unsigned char[]> testSer = utxo.serialize();
+            std::unique_ptr<unsigned char[]> testSer = utxo->serialize();
             std::memcpy(&testsz, testSer.get(), sizeof(size_t));
-            size_t ts_size = utxo.getSize();
+            size_t ts_size = utxo->getSize();
 
             if (testsz == ts_size) {
                 out.txSize = msg.size();
@@ -237,6 +247,7 @@ utxout Wallet::outUTXO(double feee, const std::vector<std::string>& rwa, const s
         else {
             util::logCall("WALLET", "outUTXO()", false, "Signature computation failed");
             std::cerr << "Signature computation failed!\n";
+            return {};
         }
     }
     else {
@@ -245,92 +256,53 @@ utxout Wallet::outUTXO(double feee, const std::vector<std::string>& rwa, const s
         return {};
     }
 
-    /* Update UTXO */
-    double utxoup = 0;
-    std::vector<transactions> newUTXO;
-    for (const auto& tx: UTXO) {
-        std::vector<double> vecam = tx.getAmmount();
-        for (double amount : vecam) {
-            utxoup += amount;
-        }
-
-        if (check <= utxoup) {
-            if (utxoup == check) {
-                check = 0.0;
-                continue;
-            }
-            else {
-                std::vector<std::string> del;
-                std::vector<std::string> delID;
-                std::vector<std::tuple<std::string, std::string, float>> votesQ;
-                std::string mwa = address;
-                std::vector<std::string> mra;
-                mra.push_back(mwa);
-                std::vector<double> namm;
-                double mamm = (utxoup - check);
-                namm.push_back(mamm);
-                transactions ttx(address, mra, namm, 0, locktimeUTXO, versionUTXO, del,
-                    delID, votesQ, util::TimeStamp());
-                newUTXO.emplace_back(ttx);
-                check = 0.0;
-                continue;
-            }
-        }
-        else {
-            check -= utxoup;
-            continue;
-        }
+    /* Spend only the selected outputs, the change becomes a wallet local output */
+    Amount gathered = 0;
+    for (const auto& [op, value] : picked) {
+        Amount spent = 0;
+        utxos.spend(op, spent);
+        gathered += spent;
+    }
+    if (gathered > check) {
+        /* Change sits after the recipients of the spending transaction */
+        utxos.add(OutPoint{utxo->getTxid(), static_cast<uint32_t>(rwa.size())}, gathered - check);
     }
-    UTXO = std::move(newUTXO);
-    UTXO.shrink_to_fit();
-    setBalance();
 
     return out;
 }
 
-void Wallet::inUTXO(const transactions& txin, size_t index) {
-
-    /* Create Personal UTXO */
-    std::vector<std::string> del;
-    size_t delSize = txin.getDelegates().size();
-    del = txin.getDelegates();
-
-    std::vector<std::string> delID;
-    size_t delIDSize = txin.getDelegatesID().size();
-    delID = txin.getDelegatesID();
-
-    std::vector<std::tuple<std::string, std::string, float>> votesQ;
-    size_t votesSize = txin.getVotes().size();
-    votesQ = txin.getVotes();
-
-    std::string mwa = address;
-    std::vector<std::string> mra;
-    mra.push_back(mwa);
-
-    std::vector<double> amm;
-    amm.push_back(txin.getAmmount()[index]);
+bool Wallet::inUTXO(const transactions& txin, size_t index) {
+    /* Re-confirmed outputs are ignored by the set */
+    return utxos.add(OutPoint{txin.getTxid(), static_cast<uint32_t>(index)}, txin.getAmmount()[index]);
+}
 
-    transactions ttx(address, mra, amm, txin.getFee(), txin.getLockTime(), txin.getVersion(), del,
-        delID, votesQ, txin.getTimeStamp());
+bool Wallet::revertUTXO(const OutPoint& out) {
+    Amount value = 0;
+    return utxos.spend(out, value);
+}
 
-    UTXO.emplace_back(ttx);
-    setBalance();
+void Wallet::seedUTXO(const unsigned int snapshotHeight, const Amount value) {
+    /* The outputs behind the balance predate the snapshot, so they are not known one by one */
+    if (value > 0) {
+        utxos.add(OutPoint{"snapshot:" + std::to_string(snapshotHeight), 0}, value);
+    }
 }
 
 bool Wallet::verifyTx(const utxout& out) {
     /* Declare variables */
-    transactions utxo = transactions::deserialize(util::toUnsignedChar(out.utxo));
+    std::optional<transactions> decoded;
+    if (!transactions::decode(std::span(reinterpret_cast<const uint8_t*>(out.utxo.data()), out.utxo.size()), decoded)) {
+        util::logCall("WALLET", "verifyTx()", false, "Malformed Transaction");
+        return false;
+    }
+    const transactions& utxo = *decoded;
     std::vector<unsigned char> hash;
     if (util::shaHash(out.utxo, hash)) {
         /* Verify Hash */
         if (ecDoVerify(out.pubkey, hash, out.utxoSignedHash)) {
             /* Verify UTXO amount > zero */
-            double totalbal = 0.0;
-            std::vector<double> tempBal = utxo.getAmmount();
-            for (double amount : tempBal) {
-                totalbal += amount;
-            }
-            if (totalbal <= 0) {
+            Amount totalbal = 0;
+            if (!utxo.totalAmm(totalbal) || totalbal <= 0) {
                 util::logCall("WALLET", "verifyTx()", false, "UTXO amount is invalid (must be greater than 0)");
                 std::cout << "UTXO amount is invalid (must be greater than 0)!\n";
                 return false;
@@ -352,30 +324,31 @@ bool Wallet::verifyTx(const utxout& out) {
 }
 
 void Wallet::listTxs() {
-    for (auto& tx: UTXO) {
-        tx.display();
+    for (const auto& [op, value] : utxos.list()) {
+        std::cout << "UTXO " << op.txid << ":" << op.index << " | Amount: " << Amounts::toString(value) << " Dash\n";
     }
 }
 
-void Wallet::setBalance() {
-    double amm = 0;
-    size_t txsize = UTXO.size();
-    for (int i = 0; i < txsize; i++) {
-        amm += UTXO[i].totalAmm();
-    }
+Amount Wallet::getBalance() const {
+    return utxos.balance();
+}
 
-    balance = amm;
+void Wallet::setCoinSelector(std::unique_ptr<CoinSelector> cs) {
+    if (cs) {
+        selector = std::move(cs);
+        util::logCall("WALLET", "setCoinSelector()", true);
+    }
 }
 
-double Wallet::getBalance() const {
-    return balance;
+const char* Wallet::getCoinSelector() const {
+    return selector->name();
 }
 
-std::string Wallet::getWalletAddr() const {
+const Address& Wallet::getWalletAddr() const {
     return address;
 }
 
-void Wallet::setWalletAddr(const std::string& wa) {
+void Wallet::setWalletAddr(const Address& wa) {
     address = wa;
 }
 
@@ -400,90 +373,21 @@ void Wallet::setVersion(float vs) {
 }
 
 std::unique_ptr<unsigned char[]> Wallet::serialize_utxout(const utxout& obj) const {
-
-    /* Calculate sizes */
-    size_t tSize = 0;
-
-    /* Calculate size and serialze public key */
-    const int len = i2d_PUBKEY(obj.pubkey.get(), nullptr);
-    std::unique_ptr<unsigned char[]> buf(new unsigned char[len]);
-    unsigned char *ptr = buf.get();
-    int written = i2d_PUBKEY(obj.pubkey.get(), &ptr);
-    size_t utSize = obj.utxo.size() + 1;
-
-
-    tSize += sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(int) + utSize + obj.utxoSignedHash.size() + len; // len == public key size
-
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    size_t offset = 0;
-
-    /* serialize utxout */
-
-    /* Serialize tSize itself */
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(tSize));
-    offset += sizeof(tSize);
-
-    /* Serialize txSize itself */
-    std::memcpy(buffer.get() + offset, &utSize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Serialize shSize itself */
-    size_t shSize = obj.utxoSignedHash.size();
-    std::memcpy(buffer.get() + offset, &shSize, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Serialize key length itself */
-    std::memcpy(buffer.get() + offset, &len, sizeof(int));
-    offset += sizeof(int);
-
-    /* Serialize utxo itself */
-    std::memcpy(buffer.get() + offset, obj.utxo.c_str(), utSize);
-    offset += utSize;
-
-    /* Serialize signed hash itself */
-    std::memcpy(buffer.get() + offset, obj.utxoSignedHash.data(), obj.utxoSignedHash.size());
-    offset += obj.utxoSignedHash.size();
-
-    /* Serialize public key itself */
-    std::memcpy(buffer.get() + offset, buf.get(), len);
-
-    ptr = nullptr;
-    return buffer;
+    return UtxoutWire::encode(obj);
 }
 
-utxout Wallet::deserialize_utxout(const std::unique_ptr<unsigned char[]>& buffer) const {
-    utxout obj;
-    size_t offset = 0;
-
-    /* Deserialize tSize (not used in this function, but read to advance the offset) */
-    size_t tSize;
-    std::memcpy(&tSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize txSize */
-    std::memcpy(&obj.txSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize shSize */
-    std::memcpy(&obj.shSize, buffer.get() + offset, sizeof(size_t));
-    offset += sizeof(size_t);
-
-    /* Deserialize public key size */
-    std::memcpy(&obj.pkeySize, buffer.get() + offset, sizeof(int));
-    offset += sizeof(int);
-
-    /* Deserialize utxo */
-    obj.utxo.assign(reinterpret_cast<const char*>(buffer.get() + offset), obj.txSize - 1);
-    offset += obj.txSize;
-
-    /* Deserialize utxoSignedHash */
-    obj.utxoSignedHash.assign(buffer.get() + offset, buffer.get() + offset + obj.shSize);
-    offset += obj.shSize;
-
-    /* Deserialize Public Key */
-    const unsigned char* pk = buffer.get() + offset;
-    EVP_PKEY* raw_key = d2i_PUBKEY(nullptr, &pk, obj.pkeySize);
-    obj.pubkey = EVP_PKEY_ptr(raw_key, EVP_PKEY_Deleter());
+bool Wallet::deserialize_utxout(const std::unique_ptr<unsigned char[]>& buffer, utxout& obj) const {
+    UtxoutWire::Decoded d;
+    if (!UtxoutWire::decode(buffer, d) || UtxoutWire::at<&utxout::pubkey>(d) == nullptr) {
+        util::logCall("WALLET", "deserialize_utxout()", false, "Malformed utxout");
+        return false;
+    }
 
-    return obj;
+    obj.txSize = UtxoutWire::extentOf<&utxout::utxo>(d);
+    obj.shSize = UtxoutWire::extentOf<&utxout::utxoSignedHash>(d);
+    obj.pkeySize = static_cast<int>(UtxoutWire::extentOf<&utxout::pubkey>(d));
+    obj.utxo = std::move(UtxoutWire::at<&utxout::utxo>(d));
+    obj.utxoSignedHash = std::move(UtxoutWire::at<&utxout::utxoSignedHash>(d));
+    obj.pubkey = std::move(UtxoutWire::at<&utxout::pubkey>(d));
+    return true;
 }
\ No newline at end of file
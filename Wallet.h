@@ -4,6 +4,8 @@
 #include "util.h"
 #include "transactions.h"
 #include "CryptoTypes.h"
+#include "UtxoSet.h"
+#include "CoinSelection.h"
 
 /*-- wallet.h ---------------------------------------------------------------
 
@@ -12,7 +14,7 @@
 
   - Generating ECDSA key pairs (public/private keys)
   - Creating unique wallet addresses
-  - Managing UTXOs (Unspent Transaction Outputs)
+  - Managing UTXOs (Unspent Transaction Outputs), indexed by outpoint
   - Signing and verifying transactions using ECDSA
   - Calculating transaction IDs (TxID)
   - Serializing and deserializing UTXOs for storage and transmission
@@ -47,16 +49,25 @@ public:
 	EVP_PKEY_ptr extract_public_key();
 
 	/* send & recieve Transactions methods */
-	utxout outUTXO(double feee, const std::vector<std::string>& rwa, const std::vector<double>& amm, const std::vector<std::string> &delegates,
-		const std::vector<std::string> &delegateID, const std::vector<std::tuple<std::string, std::string, float>> &votesQueue);
-	void inUTXO(const transactions& txin, size_t index);
+	utxout outUTXO(Amount feee, const std::vector<Address>& rwa, const std::vector<Amount>& amm, const std::vector<std::string> &delegates,
+		const std::vector<std::string> &delegateID, const std::vector<std::tuple<Address, std::string, float>> &votesQueue);
+	bool inUTXO(const transactions& txin, size_t index);
+
+	/* Undo of a disconnected block's credit, false if the output is already spent */
+	bool revertUTXO(const OutPoint& out);
+
+	/* Confirmed balance carried over from a state snapshot, held as one output */
+	void seedUTXO(unsigned int snapshotHeight, Amount value);
 
 	bool verifyTx(const utxout& out);
 	void listTxs();
-	void setBalance();
-	double getBalance() const;
-	std::string getWalletAddr() const;
-	void setWalletAddr(const std::string& wa);
+	Amount getBalance() const;
+
+	/* Coin selection strategy used by outUTXO, see CoinSelection.h */
+	void setCoinSelector(std::unique_ptr<CoinSelector> cs);
+	const char* getCoinSelector() const;
+	const Address& getWalletAddr() const;
+	void setWalletAddr(const Address& wa);
 	EVP_PKEY_ptr getPubKey() const;
 	unsigned short getLockTime() const;
 	void setLockTime(unsigned short lk);
@@ -65,21 +76,27 @@ public:
 
 	/* De-serialize utxo and its data */
 	std::unique_ptr<unsigned char[]> serialize_utxout(const utxout& obj) const ;
-	utxout deserialize_utxout(const std::unique_ptr<unsigned char[]>& buffer) const ;
+	bool deserialize_utxout(const std::unique_ptr<unsigned char[]>& buffer, utxout& obj) const ;
 
 private:
+	/* utxout wire layout: tSize | utxo size (NUL included) | signature size | key size | utxo | signature | DER key */
+	using UtxoutWire = serial::Layout<utxout,
+		serial::Extent<&utxout::utxo>, serial::Extent<&utxout::utxoSignedHash>, serial::ExtentOf<int, &utxout::pubkey>,
+		serial::FieldAs<serial::SizedCStr, &utxout::utxo>, serial::Field<&utxout::utxoSignedHash>,
+		serial::Field<&utxout::pubkey>>;
+
 	/* Wallet address Function, Creates wallet address for newly created wallets */
-	std::string genAddress() const;
+	Address genAddress() const;
 
 	/* Private Wallet Variables */
-	std::string address;
+	Address address;
 	static util utility;
 	const EVP_PKEY_ptr keyPair = createEVP_PKEY();
-	std::vector<transactions> UTXO;
+	UtxoSet utxos;
+	std::unique_ptr<CoinSelector> selector = std::make_unique<OldestFirstSelector>();
 	const char* curvename = "P-256";
 	const EVP_PKEY_ptr pubKeyP = createEVP_PKEY();
 	unsigned short txCount;
-	double balance;
 	unsigned short locktimeUTXO;
 	float versionUTXO;
 
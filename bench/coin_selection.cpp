@@ -0,0 +1,139 @@
+#include "CoinSelection.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+/*-- bench/coin_selection.cpp -------------------------------------------------
+
+  Compares the coin selection strategies on synthetic wallets. Every
+  strategy spends the same series of targets from its own copy of the
+  wallet, picked outputs are removed and change goes back in as a new
+  output, the way a Wallet spends over time.
+
+  Wallets are:
+	 small:        Many small outputs of similar value
+	 skewed:       Mostly dust with a few large outputs
+	 near-exact:   Targets just under the sum of a few existing outputs,
+	               the case bnb is meant to settle without change
+
+  Reported per strategy: inputs per spend, change outputs minted, outputs
+  left in the wallet & time per select().
+-------------------------------------------------------------------------*/
+
+namespace {
+
+constexpr int SPENDS = 500;
+
+struct Wallet
+{
+	UtxoSet utxos;
+	uint64_t next = 0; // txid counter for new outputs
+
+	void receive(const Amount value) {
+		utxos.add(OutPoint{"bench" + std::to_string(next++), 0}, value);
+	}
+};
+
+using Targets = std::vector<Amount>;
+
+Wallet smallCoins(std::mt19937_64& rng) {
+	Wallet w;
+	std::uniform_int_distribution<Amount> value(Amounts::COIN_UNITS / 100, Amounts::COIN_UNITS / 10);
+	for (int i = 0; i < 5000; i++) {
+		w.receive(value(rng));
+	}
+	return w;
+}
+
+Wallet skewedCoins(std::mt19937_64& rng) {
+	Wallet w;
+	std::lognormal_distribution<double> value(0.0, 2.5);
+	for (int i = 0; i < 5000; i++) {
+		const double v = value(rng) * static_cast<double>(Amounts::COIN_UNITS / 1000);
+		w.receive(std::clamp<Amount>(static_cast<Amount>(v), 1, 1000 * Amounts::COIN_UNITS));
+	}
+	return w;
+}
+
+Targets randomTargets(std::mt19937_64& rng, const Amount lo, const Amount hi) {
+	std::uniform_int_distribution<Amount> target(lo, hi);
+	Targets t;
+	for (int i = 0; i < SPENDS; i++) {
+		t.push_back(target(rng));
+	}
+	return t;
+}
+
+/* Sum of 1-3 existing outputs, less a remainder under the default bnb change window */
+Targets nearExactTargets(std::mt19937_64& rng, const Wallet& w) {
+	const std::vector<std::pair<OutPoint, Amount>> all = w.utxos.list();
+	std::uniform_int_distribution<size_t> pick(0, all.size() - 1);
+	std::uniform_int_distribution<int> count(1, 3);
+	std::uniform_int_distribution<Amount> under(0, Amounts::COIN_UNITS / 2000);
+	Targets t;
+	for (int i = 0; i < SPENDS; i++) {
+		Amount sum = 0;
+		for (int k = count(rng); k > 0; k--) {
+			sum += all[pick(rng)].second;
+		}
+		t.push_back(std::max<Amount>(1, sum - under(rng)));
+	}
+	return t;
+}
+
+void run(const char* wallet, const Wallet& start, const Targets& targets) {
+	std::printf("\n%s wallet: %zu outputs, balance %s\n", wallet, start.utxos.size(),
+		Amounts::toString(start.utxos.balance()).c_str());
+	std::printf("  %-12s %8s %12s %8s %8s %12s\n", "strategy", "spends", "inputs/spend", "change", "left", "us/select");
+
+	for (const char* name : {"oldest", "largest", "bnb", "consolidate"}) {
+		const std::unique_ptr<CoinSelector> selector = CoinSelector::create(name);
+		Wallet w = start;
+		size_t spends = 0;
+		size_t inputs = 0;
+		size_t change = 0;
+		std::chrono::nanoseconds spent{0};
+
+		for (const Amount target : targets) {
+			CoinPick picked;
+			const auto t0 = std::chrono::steady_clock::now();
+			const bool ok = selector->select(w.utxos, target, picked);
+			spent += std::chrono::steady_clock::now() - t0;
+			if (!ok) {
+				continue;
+			}
+
+			Amount excess = -target;
+			for (const auto& [op, value] : picked) {
+				Amount v = 0;
+				w.utxos.spend(op, v);
+				excess += v;
+			}
+			spends++;
+			inputs += picked.size();
+			if (excess > selector->changeWindow()) {
+				change++;
+				w.receive(excess);
+			}
+		}
+
+		const double perSpend = spends ? static_cast<double>(inputs) / static_cast<double>(spends) : 0.0;
+		const double perSelect = static_cast<double>(spent.count()) / 1000.0 / static_cast<double>(targets.size());
+		std::printf("  %-12s %8zu %12.2f %8zu %8zu %12.1f\n", name, spends, perSpend, change, w.utxos.size(), perSelect);
+	}
+}
+
+} // namespace
+
+int main() {
+	std::mt19937_64 rng(20240601);
+
+	const Wallet small = smallCoins(rng);
+	run("small", small, randomTargets(rng, Amounts::COIN_UNITS / 20, Amounts::COIN_UNITS / 2));
+
+	const Wallet skewed = skewedCoins(rng);
+	run("skewed", skewed, randomTargets(rng, Amounts::COIN_UNITS / 1000, Amounts::COIN_UNITS / 5));
+
+	run("near-exact", small, nearExactTargets(rng, small));
+	return 0;
+}
@@ -12,6 +12,9 @@ enum Command {
     GET_BLOCK,
     SET_WALLET,
     VOTE,
+    COIN_SELECT,
+    ADDR_BALANCE,
+    PRUNE,
     EXIT,
     UNKNOWN
 };
@@ -28,31 +31,55 @@ std::unordered_map<std::string, Command> commandMap = {
     {"set_wallet", SET_WALLET},
     {"get_block", GET_BLOCK},
     {"vote", VOTE},
+    {"coin_select", COIN_SELECT},
+    {"addr_balance", ADDR_BALANCE},
+    {"prune", PRUNE},
     {"exit", EXIT}
 };
 
 void displayHelp() {
     std::cout << "\nAvailable Commands:\n";
     std::cout << "  balance          - Get wallet balance\n";
+    std::cout << "  addr_balance     - Get confirmed balance of any address\n";
     std::cout << "  tx_history       - Get transaction history\n";
     std::cout << "  send_tx          - Send transaction\n";
     std::cout << "  vote             - Vote for delegates\n";
     std::cout << "  set_wallet       - Change wallets \n";
+    std::cout << "  coin_select      - Choose coin selection (oldest|largest|bnb|consolidate)\n";
     std::cout << "  get_tx [txid]    - Get specific transaction details\n";
     std::cout << "  blockchain_info  - Get blockchain details\n";
     std::cout << "  request_delegate - Get Delegate ID for voting\n";
     std::cout << "  get_block [num]  - Get specific block details\n";
+    std::cout << "  prune [num]      - Keep only the last num block bodies (0 = keep all)\n";
     std::cout << "  connected_peers  - Get connected peers\n";
     std::cout << "  exit             - Terminate the program\n";
 }
 
 void getBalance(const Peer &p) {
-    std::cout << "\nWallet Balance: %" << p.getBalance() << " Dash\n";
+    std::cout << "\nWallet Balance: %" << Amounts::toString(p.getBalance()) << " Dash\n";
+}
+
+void getAddressBalance(const Peer &p) {
+    std::string wallet_addr;
+    std::cout << "\nEnter Wallet Address: ";
+    std::cin >> wallet_addr;
+
+    Address wa;
+    if (!Address::fromString(wallet_addr, wa)) {
+        std::cout << "\nInvalid wallet address: " << wallet_addr << "\n";
+        return;
+    }
+    std::cout << "\nAddress Balance: %" << Amounts::toString(p.getAddressBalance(wa)) << " Dash\n";
 }
 
 void getTransactionHistory(Peer &p) {
     std::cout << "\nTransaction History:\n";
     p.listTx();
+
+    size_t page = 0;
+    std::cout << "\nEnter history page (0 = newest): ";
+    std::cin >> page;
+    p.txHistory(page);
 }
 
 void sendTransaction(Peer &p) {
@@ -60,18 +87,32 @@ void sendTransaction(Peer &p) {
     std::cout << "\nEnter number of senders: ";
     std::cin >> numSenders;
 
-    std::vector<std::string> recipients;
-    std::vector<double> amounts;
+    std::vector<Address> recipients;
+    std::vector<Amount> amounts;
 
     for (int i = 0; i < numSenders; ++i) {
         std::string address;
-        double amount;
+        std::string amountStr;
         std::cout << "Sender " << (i + 1) << " - Enter wallet address: ";
         std::cin >> address;
         std::cout << "Enter amount to send: ";
-        std::cin >> amount;
+        std::cin >> amountStr;
+
+        /* Base58Check is only decoded here, at the CLI boundary */
+        Address recipient;
+        if (!Address::fromString(address, recipient)) {
+            std::cout << "\nInvalid wallet address: " << address << "\n";
+            return;
+        }
+
+        /* Amounts are parsed exactly into base units, never through a double */
+        Amount amount = 0;
+        if (!Amounts::parse(amountStr, amount) || amount == 0) {
+            std::cout << "\nInvalid amount: " << amountStr << "\n";
+            return;
+        }
 
-        recipients.push_back(address);
+        recipients.push_back(recipient);
         amounts.push_back(amount);
     }
 
@@ -84,11 +125,11 @@ void sendTransaction(Peer &p) {
 }
 
 void vote(Peer &p) {
-    const double amount = p.getBalance();
-    std::string sender = p.getWalletAddress();
+    const double amount = Amounts::toCoins(p.getBalance());
+    Address sender = p.getWalletAddress();
     std::string ID = p.get_this_delID();
     float totalVotes = 0;
-    std::vector<std::tuple<std::string, std::string, float>> votes;
+    std::vector<std::tuple<Address, std::string, float>> votes;
     int numDelegates;
 
     if (ID == "error" || ID.empty()) {
@@ -126,7 +167,7 @@ void vote(Peer &p) {
     // Display recorded votes
     std::cout << "\nRecorded Votes:\n";
     for (const auto& vote : votes) {
-        std::cout << std::get<0>(vote) << " voted for " << std::get<1>(vote)
+        std::cout << std::get<0>(vote).toString() << " voted for " << std::get<1>(vote)
                   << " with " << std::get<2>(vote) << " votes.\n";
     }
 }
@@ -136,7 +177,12 @@ void setWallet(Peer &p) {
     std::cout << "\nEnter Wallet Address: ";
     std::cin >> wallet_addr;
 
-    p.set_address(wallet_addr);
+    Address wa;
+    if (!Address::fromString(wallet_addr, wa)) {
+        std::cout << "\nInvalid wallet address: " << wallet_addr << "\n";
+        return;
+    }
+    p.set_address(wa);
 }
 
 void getTransactionInfo(Peer &p) {
@@ -153,11 +199,37 @@ void getBlockchainInfo(Peer &p) {
 }
 
 void requestDelegate(Peer &p) {
-    const std::string delegateID = p.getWalletAddress();
+    const std::string delegateID = p.getWalletAddress().toString();
     std::cout << "WARNING: SECURE DELEGATE ID...\n";
     std::cout << "\nDelegate ID: " << delegateID << "\n";
 }
 
+void setCoinSelection(Peer &p) {
+    std::string strategy;
+    std::cout << "\nEnter strategy (oldest|largest|bnb|consolidate): ";
+    std::cin >> strategy;
+
+    if (p.setCoinSelection(strategy)) {
+        std::cout << "\nCoin selection set to " << strategy << "\n";
+    }
+    else {
+        std::cout << "\nUnknown strategy: " << strategy << "\n";
+    }
+}
+
+void setPruning(Peer &p) {
+    unsigned int keep = 0;
+    std::cout << "\nEnter block bodies to keep (0 = archival): ";
+    std::cin >> keep;
+
+    if (p.setPruning(keep)) {
+        std::cout << "\nPruning set to " << keep << " blocks\n";
+    }
+    else {
+        std::cout << "\nPrune depth must be 0 or at least the confirmation period\n";
+    }
+}
+
 void getSpecificBlock(Peer &p) {
     int blockNum;
     std::cout << "\nEnter block number: ";
@@ -198,8 +270,18 @@ void processCommand(std::string& command, Peer& p) {
         case VOTE:
             vote(p);
             break;
+        case COIN_SELECT:
+            setCoinSelection(p);
+            break;
+        case ADDR_BALANCE:
+            getAddressBalance(p);
+            break;
+        case PRUNE:
+            setPruning(p);
+            break;
         case EXIT:
             std::cout << "Terminating DashChain...\n";
+            p.dumpMempool();
             exit(0);
             break;
         default:
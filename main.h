@@ -12,6 +12,7 @@
 // Function declarations
 void displayHelp();
 void getBalance();
+void getAddressBalance();
 void vote();
 void getTransactionHistory();
 void sendTransaction();
@@ -20,6 +21,8 @@ void getBlockchainInfo();
 void requestDelegate();
 void getSpecificBlock();
 void setWallet();
+void setCoinSelection();
+void setPruning();
 void processCommand(std::string& command, Peer& p);
 
 #endif //MAIN_H
@@ -3,36 +3,54 @@
 ---------------------------------------------------------------------------*/
 #include "transactions.h"
 
-transactions::transactions(std::string sa, std::vector<std::string> ra, std::vector<double> amm, double fe, unsigned short lk,
-    float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID, std::vector<std::tuple<std::string, std::string, float>> votes,
-    unsigned long long timestamp, std::string tid)
-    : timestamp(timestamp),
-    txid(tid),
+transactions::transactions(Address sa, std::vector<Address> ra, std::vector<Amount> amm, Amount fe, unsigned short lk,
+    float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID, std::vector<std::tuple<Address, std::string, float>> votes,
+    unsigned long long timestamp)
+    : delegates(std::move(delegate)),
+    delegateID(std::move(delegatesID)),
+    votesQueue(std::move(votes)),
+    timestamp(timestamp),
     sendAddr(sa),
-    recieveAddr(ra),
+    recieveAddr(std::move(ra)),
     ammount(std::move(amm)),
     fee(fe),
     locktime(lk),
-    version(v),
-    delegates(std::move(delegate)),
+    version(v)
+{
+    /* Every other member is set, the content address can be computed once */
+    txid = computeTxid();
+}
+
+transactions::transactions(Decoded, Address sa, std::vector<Address> ra, std::vector<Amount> amm, Amount fe, unsigned short lk,
+    float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID, std::vector<std::tuple<Address, std::string, float>> votes,
+    unsigned long long timestamp, std::string id)
+    : delegates(std::move(delegate)),
     delegateID(std::move(delegatesID)),
-    votesQueue(std::move(votes))
+    votesQueue(std::move(votes)),
+    timestamp(timestamp),
+    txid(std::move(id)),
+    sendAddr(sa),
+    recieveAddr(std::move(ra)),
+    ammount(std::move(amm)),
+    fee(fe),
+    locktime(lk),
+    version(v)
 {
 }
 
 /* Copy */
 transactions::transactions(const transactions& copy)
-    :timestamp(copy.timestamp),
+    :delegates(copy.delegates),
+    delegateID(copy.delegateID),
+    votesQueue(copy.votesQueue),
+    timestamp(copy.timestamp),
     txid(copy.txid),
     sendAddr(copy.sendAddr),
     recieveAddr(copy.recieveAddr),
     ammount(copy.ammount),
     fee(copy.fee),
     locktime(copy.locktime),
-    version(copy.version),
-    delegates(copy.delegates),
-    delegateID(copy.delegateID),
-    votesQueue(copy.votesQueue)
+    version(copy.version)
 {
 }
 
@@ -52,99 +70,33 @@ const std::string transactions::getTxid() const {
     return txid;
 }
 
-std::string transactions::setTxid(){
-    /* Create a random number generator */
-    std::random_device rd; // Seed for random number generator
-    std::mt19937 gen(rd()); // Mersenne Twister engine
-    std::uniform_int_distribution<unsigned int> distrib(0, 4294967295); // Define the range
-
-    /* Generate a random number */
-    const unsigned int random_number = distrib(gen);
-    const unsigned int random_numberA = distrib(gen);
-    std::string random, randomA;
-
-    /* Achieve Uniformity For First Random Number */
-    if (random_number < 10) {
-        random = "000000000" + util::toString(random_number);
-    }
-    else if (random_number < 100) {
-        random = "00000000" + util::toString(random_number);
-    }
-    else if (random_number < 1000) {
-        random = "0000000" + util::toString(random_number);
-    }
-    else if (random_number < 10000) {
-        random = "000000" + util::toString(random_number);
-    }
-    else if (random_number < 100000) {
-        random = "00000" + util::toString(random_number);
-    }
-    else if (random_number < 1000000) {
-        random = "0000" + util::toString(random_number);
-    }
-    else if (random_number < 10000000) {
-        random = "000" + util::toString(random_number);
-    }
-    else if (random_number < 100000000) {
-        random = "00" + util::toString(random_number);
-    }
-    else if (random_number < 1000000000) {
-        random = "0" + util::toString(random_number);
-    }
-    else {
-        random = util::toString(random_number);
-    }
+std::string transactions::computeTxid() const {
+    /* txid = SHA3-512 of the canonical encoding, truncated to 256 bits */
+    const std::unique_ptr<unsigned char[]> enc = serialize();
+    size_t encSize = 0;
+    std::memcpy(&encSize, enc.get(), sizeof(size_t));
 
-    /* Achieve Uniformity For Second Random Number */
-    if (random_numberA < 10) {
-        randomA = "000000000" + util::toString(random_number);
-    }
-    else if (random_number < 100) {
-        randomA = "00000000" + util::toString(random_number);
-    }
-    else if (random_number < 1000) {
-        randomA = "0000000" + util::toString(random_number);
-    }
-    else if (random_number < 10000) {
-        randomA = "000000" + util::toString(random_number);
-    }
-    else if (random_number < 100000) {
-        randomA = "00000" + util::toString(random_number);
+    std::vector<unsigned char> hash;
+    if (!util::shaHash(std::string(reinterpret_cast<const char*>(enc.get()), encSize), hash)) {
+        util::logCall("TRANSACTIONS", "computeTxid()", false, "Hash Failed");
+        return "";
     }
-    else if (random_number < 1000000) {
-        randomA = "0000" + util::toString(random_number);
-    }
-    else if (random_number < 10000000) {
-        randomA = "000" + util::toString(random_number);
-    }
-    else if (random_number < 100000000) {
-        randomA = "00" + util::toString(random_number);
-    }
-    else if (random_number < 1000000000) {
-        randomA = "0" + util::toString(random_number);
-    }
-    else {
-        randomA = util::toString(random_number);
-    }
-
-    random += randomA;
-    std::string tx_id = ("0X0017" + random + util::toString(util::TimeStamp()));
-    return tx_id;
+    return util::toHex(hash.data(), 32);
 }
 
-std::string transactions::getSendAddr() const {
+const Address& transactions::getSendAddr() const {
     return sendAddr;
 }
 
-std::vector<std::string> transactions::getRecieveAddr() const {
+const std::vector<Address>& transactions::getRecieveAddr() const {
     return recieveAddr;
 }
 
-std::vector<double> transactions::getAmmount() const {
+const std::vector<Amount>& transactions::getAmmount() const {
     return ammount;
 }
 
-double transactions::getFee() const {
+Amount transactions::getFee() const {
     return fee;
 }
 
@@ -164,12 +116,12 @@ std::vector<std::string> transactions::getDelegatesID() const {
     return delegateID;
 }
 
-std::vector<std::tuple<std::string, std::string, float>> transactions::getVotes() const {
+std::vector<std::tuple<Address, std::string, float>> transactions::getVotes() const {
     return votesQueue;
 }
 
 bool transactions::inputsValid() const {
-    if (timestamp == 0 || locktime == 0 || version == 0 || txid.empty() || sendAddr.empty()) {
+    if (timestamp == 0 || locktime == 0 || version == 0 || txid.empty() || sendAddr.isNull()) {
         util::logCall("TRANSACTIONS", "inputsValid()", false, "Inputs Invalid");
         return false;
     }
@@ -183,25 +135,24 @@ bool transactions::outputsValid() const {
         return false;
     }
 
-    for (const double i : ammount) {
-        if (i == 0) {
-            util::logCall("TRANSACTIONS", "outputsValid()", false, "AMM EMPTY");
+    for (const Amount i : ammount) {
+        if (i <= 0 || i > Amounts::MAX_MONEY) {
+            util::logCall("TRANSACTIONS", "outputsValid()", false, "AMM OUT OF RANGE");
             return false;
         }
     }
 
+    Amount total = 0;
+    if (!Amounts::inRange(fee) || !totalAmm(total) || !Amounts::add(total, fee, total)) {
+        util::logCall("TRANSACTIONS", "outputsValid()", false, "AMM OVERFLOW");
+        return false;
+    }
+
     return true; // Return only after checking all values
 }
 
-double transactions::totalAmm() const {
-    double amm = 0;
-    size_t ammsize = ammount.size();
-
-    for (int i = 0; i < ammsize; i++) {
-        amm += ammount[i];
-    }
-
-    return amm;
+bool transactions::totalAmm(Amount& total) const {
+    return Amounts::sum(ammount, total);
 }
 
 void transactions::display() {
@@ -214,15 +165,15 @@ void transactions::display() {
     std::cout << "Timestamp        : " << timestamp << "\n";
     std::cout << "Version         : " << version << "\n";
     std::cout << "Locktime        : " << locktime << "\n";
-    std::cout << "Transaction Fee  : " << fee << " Dash\n";
+    std::cout << "Transaction Fee  : " << Amounts::toString(fee) << " Dash\n";
 
     std::cout << "\n**Sender Information**\n";
-    std::cout << "Sender Address   : " << sendAddr << "\n";
+    std::cout << "Sender Address   : " << sendAddr.toString() << "\n";
 
     std::cout << "\n**Recipients**\n";
     for (size_t i = 0; i < recieveAddr.size(); ++i) {
-        std::cout << "Recipient " << (i + 1) << " : " << recieveAddr[i]
-            << " | Amount: " << ammount[i] << " Dash\n";
+        std::cout << "Recipient " << (i + 1) << " : " << recieveAddr[i].toString()
+            << " | Amount: " << Amounts::toString(ammount[i]) << " Dash\n";
     }
 
     std::cout << "\n**Delegates & Voting**\n";
@@ -236,7 +187,7 @@ void transactions::display() {
 
     std::cout << "\n**Votes Queue**\n";
     for (const auto& vote : votesQueue) {
-        std::cout << "Voter: " << std::get<0>(vote)
+        std::cout << "Voter: " << std::get<0>(vote).toString()
             << " | Delegate: " << std::get<1>(vote)
             << " | Weight: " << std::get<2>(vote) << "\n";
     }
@@ -246,362 +197,48 @@ void transactions::display() {
 
 /* Serialize method */
 std::unique_ptr<unsigned char[]> transactions::serialize() const {
-    /*
-        There Will be 6 uint32_t, 3 short & 1 size_t Variables at the start of every Buffer
-        This Will Account For The Size Of:
-            uint32_t (In Order)             short (In Order)            size_t (In Order)
-            1. sendAddr                                                    tSize
-            2. txid
-            3. ammount                      short numAmm;
-            4. sendPkey
-            5. recieveAddr                  short recAddAmm
-            6. recievePkeys                 short prkAmm;
-
-            NOTE: txid will be serialized as a string for efficiency purposes, reflected in deserialize
-    */
-
-    /* Variables */
-    // Sizes of: Locktime, Version, Fee & Timestamp (In That Order)
-    size_t tSize = 0;
-
-    /* Variable Vars */
-    size_t numAmm = 0, recAddAmm = 0, delAmm = 0, delIDAmm = 0, vQueAmm = 0;
-    size_t sendSize = 0, txidSize = 0, ammSize = 0, recAddSize = 0, delSize = 0, delIDSize = 0, vQueSize = 0;
-
-    sendSize = sendAddr.size() + 1; // For Null terminator
-
-    /* Calculate txid Size */
-    txidSize = txid.size() + 1; //For Null terminator
-
-    numAmm = ammount.size();
-    ammSize = ammount.size() * sizeof(double); // Calculate size of amount vector
-
-    /* Calculate recieveAddr Size */
-    recAddAmm = recieveAddr.size();
-    for (const auto& addr : recieveAddr) {
-        recAddSize += addr.size() + 1; // Size for length + actual string content
-    }
-
-    delAmm = delegates.size();
-    for (const auto& d: delegates) {
-        delSize +=  d.size() + 1;
-    }
-
-    delIDAmm = delegateID.size();
-    for (const auto& id: delegateID) {
-        delIDSize += id.size() + 1;
-    }
-
-    vQueAmm = votesQueue.size();
-    for (const auto& vote: votesQueue) {
-        vQueSize += std::get<0>(vote).size() + 1;
-        vQueSize += std::get<1>(vote).size() + 1;
-        vQueSize += sizeof(float);
-    }
+    return Wire::encode(*this);
+}
 
-    /* Create Buffer */
-    tSize = tSize + sizeof(unsigned long long) + sizeof(double) + sizeof(unsigned short) + sizeof(float);
-    tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-    tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-    tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-    tSize = tSize + sendSize + txidSize + ammSize + recAddSize + delSize + delIDSize + vQueSize;
-
-    /* Allocate memory for buffer */
-    std::unique_ptr<unsigned char[]> buffer(new unsigned char[tSize]);
-    size_t offset = 0;
-
-    /* Serialize tSize itself */
-    std::memcpy(buffer.get() + offset, &tSize, sizeof(tSize));
-    offset += sizeof(tSize);
-
-    /* Serialize numAmm itself */
-    std::memcpy(buffer.get() + offset, &numAmm, sizeof(numAmm));
-    offset += sizeof(numAmm);
-
-    /* Serialize recAddAmm itself */
-    std::memcpy(buffer.get() + offset, &recAddAmm, sizeof(recAddAmm));
-    offset += sizeof(recAddAmm);
-
-    /* Serialize delAmm itself */
-    std::memcpy(buffer.get() + offset, &delAmm, sizeof(delAmm));
-    offset += sizeof(delAmm);
-
-    /* Serialize delIDAmm itself */
-    std::memcpy(buffer.get() + offset, &delIDAmm, sizeof(delIDAmm));
-    offset += sizeof(delIDAmm);
-
-    /* Serialize vQueAmm itself */
-    std::memcpy(buffer.get() + offset, &vQueAmm, sizeof(vQueAmm));
-    offset += sizeof(vQueAmm);
-
-    /* Serialize sendSize itself */
-    std::memcpy(buffer.get() + offset, &sendSize, sizeof(sendSize));
-    offset += sizeof(sendSize);
-
-    /* Serialize txidSize itself */
-    std::memcpy(buffer.get() + offset, &txidSize, sizeof(txidSize));
-    offset += sizeof(txidSize);
-
-    /* Serialize ammSize itself */
-    std::memcpy(buffer.get() + offset, &ammSize, sizeof(ammSize));
-    offset += sizeof(ammSize);
-
-    /* Serialize recAddSize itself */
-    std::memcpy(buffer.get() + offset, &recAddSize, sizeof(recAddSize));
-    offset += sizeof(recAddSize);
-
-    /* Serialize delSize itself */
-    std::memcpy(buffer.get() + offset, &delSize, sizeof(delSize));
-    offset += sizeof(delSize);
-
-    /* Serialize delIDSize itself */
-    std::memcpy(buffer.get() + offset, &delIDSize, sizeof(delIDSize));
-    offset += sizeof(delIDSize);
-
-    /* Serialize vQueSize itself */
-    std::memcpy(buffer.get() + offset, &vQueSize, sizeof(vQueSize));
-    offset += sizeof(vQueSize);
-
-    /* Serialize lock-time (2 bytes) */
-    std::memcpy(buffer.get() + offset, &locktime, sizeof(locktime));
-    offset += sizeof(locktime);
-
-    /* Serialize version (4 bytes) */
-    std::memcpy(buffer.get() + offset, &version, sizeof(version));
-    offset += sizeof(version);
-
-    /* Serialize fee (8 bytes) */
-    std::memcpy(buffer.get() + offset, &fee, sizeof(fee));
-    offset += sizeof(fee);
-
-    /* Serialize timestamp (8 bytes) */
-    std::memcpy(buffer.get() + offset, &timestamp, sizeof(timestamp));
-    offset += sizeof(timestamp);
-
-    /* Serialize sendAddr (variable) */
-    std::memcpy(buffer.get() + offset, sendAddr.c_str(), sendSize);
-    offset += sendSize;
-
-    /* Serialize ammount (variable) */
-    std::memcpy(buffer.get() + offset, ammount.data(), ammSize);
-    offset += ammSize;
-
-    /* Serialize txid (variable) */
-    std::memcpy(buffer.get() + offset, txid.c_str(), txidSize);
-    offset += txidSize;
-
-    /* Serialize recieveAddr (variable) */
-    std::unique_ptr<unsigned char[]> tbuff(new unsigned char[recAddSize]);
-    size_t toff = 0;
-    for (const auto& str : recieveAddr) {
-        std::memcpy(tbuff.get() + toff, str.c_str(), str.size() + 1); // +1 to copy null terminator
-        toff += str.size() + 1;  // Update offset for the next string
-    }
-    std::memcpy(buffer.get() + offset, tbuff.get(), toff);
-    offset += toff;
-
-    /* Serialize delegates (variable) */
-    std::unique_ptr<unsigned char[]> tbuff1(new unsigned char[delSize]);
-    size_t toff1 = 0;
-    for (const auto& s : delegates) {
-        std::memcpy(tbuff1.get() + toff1, s.c_str(), s.size() + 1);
-        toff1 += s.size() + 1;
-    }
-    std::memcpy(buffer.get() + offset, tbuff1.get(), toff1);
-    offset += toff1;
-
-    /* Serialize delegateID (variable) */
-    std::unique_ptr<unsigned char[]> tbuff2(new unsigned char[delIDSize]);
-    size_t toff2 = 0;
-    for (const auto& s : delegateID) {
-        std::memcpy(tbuff2.get() + toff2, s.c_str(), s.size() + 1);
-        toff2 += s.size() + 1;
-    }
-    std::memcpy(buffer.get() + offset, tbuff2.get(), toff2);
-    offset += toff2;
-
-    /* Serialize votesQueue (variable) */
-    for (const auto& tup : votesQueue) {
-        const std::string& s1 = std::get<0>(tup);
-        std::memcpy(buffer.get() + offset, s1.c_str(), s1.size() + 1);
-        offset += s1.size() + 1;
-        const std::string& s2 = std::get<1>(tup);
-        std::memcpy(buffer.get() + offset, s2.c_str(), s2.size() + 1);
-        offset += s2.size() + 1;
-        float flt = std::get<2>(tup);
-        std::memcpy(buffer.get() + offset, &flt, sizeof(flt));
-        offset += sizeof(flt);
-    }
+size_t transactions::getSize() const {
+    return Wire::size(*this);
+}
 
-    return buffer; // Return the serialized buffer
+void transactions::serializeTo(unsigned char* out) const {
+    Wire::write(*this, out);
 }
 
-/* Deserialize method */
-transactions transactions::deserialize(const std::unique_ptr<unsigned char[]>& data) {
-    size_t offset = 0;
-
-    /* Deserialize tSize */
-    size_t tSize;
-    std::memcpy(&tSize, data.get() + offset, sizeof(tSize));
-    offset += sizeof(tSize);
-
-    /* Deserialize numAmm */
-    size_t numAmm;
-    std::memcpy(&numAmm, data.get() + offset, sizeof(numAmm));
-    offset += sizeof(numAmm);
-
-    /* Deserialize recAddAmm */
-    size_t recAddAmm;
-    std::memcpy(&recAddAmm, data.get() + offset, sizeof(recAddAmm));
-    offset += sizeof(recAddAmm);
-
-    /* Deserialize delAmm */
-    size_t delAmm;
-    std::memcpy(&delAmm, data.get() + offset, sizeof(delAmm));
-    offset += sizeof(delAmm);
-
-    /* Deserialize delIDAmm */
-    size_t delIDAmm;
-    std::memcpy(&delIDAmm, data.get() + offset, sizeof(delIDAmm));
-    offset += sizeof(delIDAmm);
-
-    /* Deserialize vQueAmm */
-    size_t vQueAmm;
-    std::memcpy(&vQueAmm, data.get() + offset, sizeof(vQueAmm));
-    offset += sizeof(vQueAmm);
-
-    /* Deserialize sendSize */
-    size_t sendSize;
-    std::memcpy(&sendSize, data.get() + offset, sizeof(sendSize));
-    offset += sizeof(sendSize);
-
-    /* Deserialize txidSize */
-    size_t txidSize;
-    std::memcpy(&txidSize, data.get() + offset, sizeof(txidSize));
-    offset += sizeof(txidSize);
-
-    /* Deserialize ammSize */
-    size_t ammSize;
-    std::memcpy(&ammSize, data.get() + offset, sizeof(ammSize));
-    offset += sizeof(ammSize);
-
-    /* Deserialize recAddSize */
-    size_t recAddSize;
-    std::memcpy(&recAddSize, data.get() + offset, sizeof(recAddSize));
-    offset += sizeof(recAddSize);
-
-    /* Deserialize delSize */
-    size_t delSize;
-    std::memcpy(&delSize, data.get() + offset, sizeof(delSize));
-    offset += sizeof(delSize);
-
-    /* Deserialize delIDSize */
-    size_t delIDSize;
-    std::memcpy(&delIDSize, data.get() + offset, sizeof(delIDSize));
-    offset += sizeof(delIDSize);
-
-    /* Deserialize vQueSize */
-    size_t vQueSize;
-    std::memcpy(&vQueSize, data.get() + offset, sizeof(vQueSize));
-    offset += sizeof(vQueSize);
-
-    /* Deserialize locktime */
-    unsigned short* lk = new unsigned short[1];
-    size_t lk_size = sizeof(unsigned short);
-    std::memcpy(lk, data.get() + offset, lk_size);
-    offset += lk_size;
-
-    /* Deserialize version */
-    float* vs = new float[1];
-    size_t vsSize = sizeof(float);
-    std::memcpy(vs, data.get() + offset, vsSize);
-    offset += vsSize;
-
-    /* Deserialize fee */
-    double* fe = new double[1];
-    size_t feSize = sizeof(double);
-    std::memcpy(fe, data.get() + offset, feSize);
-    offset += feSize;
-
-    /* Deserialize timestamp */
-    unsigned long long* ts = new unsigned long long[1];
-    size_t tsSize = sizeof(unsigned long long);
-    std::memcpy(ts, data.get() + offset, tsSize);
-    offset += tsSize;
-
-    /* Deserialize sendAddr */
-    std::string sa;
-    sa.resize(sendSize);
-    sa.assign(reinterpret_cast<const char*>(data.get() + offset), sendSize - 1);
-    offset += sendSize;
-
-    /* Deserialize ammount */
-    std::vector<double> am;
-    am.resize(numAmm);
-    std::memcpy(am.data(), data.get() + offset, ammSize);
-    offset += ammSize;
-
-    /* Deserialize txid */
-    std::string temStid;
-    temStid.resize(txidSize);
-    temStid.assign(reinterpret_cast<const char*>(data.get() + offset), txidSize - 1);
-    offset += txidSize;
-
-    /* Deserialize recieveAddr */
-    std::vector<std::string> tempra;
-    tempra.resize(recAddAmm);
-    for (auto& addr : tempra) {
-        size_t len = std::strlen(reinterpret_cast<const char*>(data.get() + offset)) + 1;
-        addr.assign(reinterpret_cast<const char*>(data.get() + offset), len - 1);
-        offset += len;
+/* Decode method */
+bool transactions::decode(const std::span<const uint8_t> in, std::optional<transactions>& out) {
+    Wire::Decoded d;
+    if (!Wire::decode(in, d)) {
+        util::logCall("TRANSACTIONS", "decode()", false, "Malformed Transaction");
+        return false;
     }
 
-    /* Deserialize delegates */
-    std::vector<std::string> delegates;
-    delegates.resize(delAmm);
-    for (auto& d : delegates) {
-        size_t len = std::strlen(reinterpret_cast<const char*>(data.get() + offset)) + 1;
-        d.assign(reinterpret_cast<const char*>(data.get() + offset), len - 1);
-        offset += len;
+    /* Canonical, so these very bytes are what serialize() would give: the txid is their digest */
+    size_t tSize = 0;
+    std::memcpy(&tSize, in.data(), sizeof(size_t));
+    std::vector<unsigned char> hash;
+    if (!util::shaHash(in.data(), tSize, hash)) {
+        util::logCall("TRANSACTIONS", "decode()", false, "Hash Failed");
+        return false;
     }
 
-    /* Deserialize delegateID */
-    std::vector<std::string> delegateID;
-    delegateID.resize(delIDAmm);
-    for (auto& id : delegateID) {
-        size_t len = std::strlen(reinterpret_cast<const char*>(data.get() + offset)) + 1;
-        id.assign(reinterpret_cast<const char*>(data.get() + offset), len - 1);
-        offset += len;
-    }
+    out.emplace(Decoded{}, Wire::at<&transactions::sendAddr>(d), std::move(Wire::at<&transactions::recieveAddr>(d)),
+        std::move(Wire::at<&transactions::ammount>(d)), Wire::at<&transactions::fee>(d),
+        Wire::at<&transactions::locktime>(d), Wire::at<&transactions::version>(d),
+        std::move(Wire::at<&transactions::delegates>(d)), std::move(Wire::at<&transactions::delegateID>(d)),
+        std::move(Wire::at<&transactions::votesQueue>(d)), Wire::at<&transactions::timestamp>(d),
+        util::toHex(hash.data(), 32));
+    return true;
+}
 
-    /* Deserialize votesQueue */
-    std::vector<std::tuple<std::string, std::string, float>> votesQueue;
-    votesQueue.resize(vQueAmm);
-    for (size_t i = 0; i < vQueAmm; ++i) {
-        const char* strPtr1 = reinterpret_cast<const char*>(data.get() + offset);
-        size_t len1 = std::strlen(strPtr1) + 1;
-        std::string voteStr1(strPtr1, len1 - 1);
-        offset += len1;
-
-        const char* strPtr2 = reinterpret_cast<const char*>(data.get() + offset);
-        size_t len2 = std::strlen(strPtr2) + 1;
-        std::string voteStr2(strPtr2, len2 - 1);
-        offset += len2;
-
-        float voteFloat;
-        std::memcpy(&voteFloat, data.get() + offset, sizeof(float));
-        offset += sizeof(float);
-
-        votesQueue[i] = std::make_tuple(voteStr1, voteStr2, voteFloat);
+bool transactions::decode(const std::unique_ptr<unsigned char[]>& data, std::optional<transactions>& out) {
+    if (!data) {
+        return false;
     }
-
-    transactions tx(sa, tempra, am, *fe, *lk, *vs, delegates, delegateID, votesQueue, *ts, temStid);
-
-    /* Cleanup */
-    delete[] fe;
-    delete[] lk;
-    delete[] vs;
-    delete[] ts;
-
-    return tx;
+    size_t tSize = 0;
+    std::memcpy(&tSize, data.get(), sizeof(size_t));
+    return decode(std::span<const uint8_t>(data.get(), tSize), out);
 }
\ No newline at end of file
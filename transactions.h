@@ -1,6 +1,11 @@
 #pragma once
 #include"util.h"
 #include "CryptoTypes.h"
+#include "Address.h"
+#include "Amount.h"
+#include "Serial.h"
+#include <optional>
+#include <span>
 
 /*-- Transactions.h ---------------------------------------------------------------
   This header file defines the Transaction Logic that will be used to send and receive
@@ -34,9 +39,15 @@ class transactions
 {
 public:
 	/* Transaction data Getters and Setters */
-	explicit transactions(std::string sa, std::vector<std::string> ra,std::vector<double> amm, double fe, unsigned short lk,
-		float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID, std::vector<std::tuple<std::string, std::string, float>> votes,
-		unsigned long long timestamp = setTimeStamp(), std::string tid = setTxid());
+	explicit transactions(Address sa, std::vector<Address> ra,std::vector<Amount> amm, Amount fe, unsigned short lk,
+		float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID, std::vector<std::tuple<Address, std::string, float>> votes,
+		unsigned long long timestamp = setTimeStamp());
+
+	/* Decoder's constructor, only decode() holds the key: txid is the digest of the bytes decoded */
+	class Decoded { friend class transactions; Decoded() = default; };
+	transactions(Decoded, Address sa, std::vector<Address> ra, std::vector<Amount> amm, Amount fe, unsigned short lk,
+		float v, std::vector<std::string> delegate, std::vector<std::string> delegatesID,
+		std::vector<std::tuple<Address, std::string, float>> votes, unsigned long long timestamp, std::string id);
 
 	/* Copy Constructor */
 	transactions(const transactions& copy);
@@ -45,105 +56,65 @@ public:
 	~transactions();
 	unsigned long long getTimeStamp() const;
 	const std::string getTxid() const;
-	std::string getSendAddr() const;
-	std::vector<std::string> getRecieveAddr() const;
-	std::vector<double> getAmmount() const;
-	double getFee() const;
+	const Address& getSendAddr() const;
+	const std::vector<Address>& getRecieveAddr() const;
+	const std::vector<Amount>& getAmmount() const;
+	Amount getFee() const;
 	unsigned short getLockTime() const;
 	float getVersion() const;
 	std::vector<std::string> getDelegates() const;
 	std::vector<std::string> getDelegatesID() const;
-	std::vector<std::tuple<std::string, std::string, float>> getVotes() const;
+	std::vector<std::tuple<Address, std::string, float>> getVotes() const;
 	static unsigned long long setTimeStamp();
-	static std::string setTxid();
+
+	/* Content address: digest of the canonical (serialized) encoding */
+	std::string computeTxid() const;
 	void display();
 
 	/* verification */
 	bool inputsValid() const;
 	bool outputsValid() const;
-	double totalAmm() const;
+	bool totalAmm(Amount& total) const;
 
 	std::unique_ptr<unsigned char[]> serialize() const;
-	static transactions deserialize(const std::unique_ptr<unsigned char[]>& data);
-
-	/* Get size for serialization */
-	size_t getSize() const {
-		/*
-        There Will be 6 uint32_t, 3 short & 1 size_t Variables at the start of every Buffer
-        This Will Account For The Size Of:
-            uint32_t (In Order)             short (In Order)            size_t (In Order)
-            1. sendAddr                                                    tSize
-            2. txid
-            3. ammount                      short numAmm;
-            4. sendPkey
-            5. recieveAddr                  short recAddAmm
-            6. recievePkeys                 short prkAmm;
-
-            NOTE: txid will be serialized as a string for efficiency purposes, reflected in deserialize
-	    */
-
-	    /* Variables */
-	    // Sizes of: Locktime, Version, Fee & Timestamp (In That Order)
-		size_t tSize = 0;
-
-		/* Variable Vars */
-		size_t numAmm = 0, recAddAmm = 0, delAmm = 0, delIDAmm = 0, vQueAmm = 0;
-		size_t sendSize = 0, txidSize = 0, ammSize = 0, recAddSize = 0, delSize = 0, delIDSize = 0, vQueSize = 0;
-
-		sendSize = sendAddr.size() + 1; // For Null terminator
 
-		/* Calculate txid Size */
-		txidSize = txid.size() + 1; //For Null terminator
+	/* Bounds checked decode straight from the bytes: every count & size is checked against what is
+	   left & must be the one serialize() writes, so only canonical encodings decode; false if not */
+	static bool decode(std::span<const uint8_t> in, std::optional<transactions>& out);
+	/* Same, for a buffer allocated at its own size prefix */
+	static bool decode(const std::unique_ptr<unsigned char[]>& data, std::optional<transactions>& out);
 
-		numAmm = ammount.size();
-		ammSize = ammount.size() * sizeof(double); // Calculate size of amount vector
-
-		/* Calculate recieveAddr Size */
-		recAddAmm = recieveAddr.size();
-		for (const auto& addr : recieveAddr) {
-			recAddSize += addr.size() + 1; // Size for length + actual string content
-		}
-
-		delAmm = delegates.size();
-		for (const auto& d: delegates) {
-			delSize +=  d.size() + 1;
-		}
-
-		delIDAmm = delegateID.size();
-		for (const auto& id: delegateID) {
-			delIDSize += id.size() + 1;
-		}
-
-		vQueAmm = votesQueue.size();
-		for (const auto& vote: votesQueue) {
-			vQueSize += std::get<0>(vote).size() + 1;
-			vQueSize += std::get<1>(vote).size() + 1;
-			vQueSize += sizeof(float);
-		}
-
-		/* Create Buffer */
-		tSize = tSize + sizeof(unsigned long long) + sizeof(double) + sizeof(unsigned short) + sizeof(float);
-		tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-		tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-		tSize = tSize + sizeof(size_t) + sizeof(size_t) + sizeof(size_t);
-		tSize = tSize + sendSize + txidSize + ammSize + recAddSize + delSize + delIDSize + vQueSize;
-
-		util::logCall("TRANSACTIONS", "getSize()", true);
-		return tSize;
-	}
+	/* Encoded size, exact; serializeTo writes that many bytes at out */
+	size_t getSize() const;
+	void serializeTo(unsigned char* out) const;
 
 private:
 	/* Variables */
 	static util ut;
 	const std::vector<std::string> delegates;
 	const std::vector<std::string> delegateID;
-	const std::vector<std::tuple<std::string, std::string, float>> votesQueue;
+	const std::vector<std::tuple<Address, std::string, float>> votesQueue;
 	const unsigned long long timestamp;
-	const std::string txid;
-	const std::string sendAddr;
-	const std::vector<std::string> recieveAddr;
-	const std::vector<double> ammount;
-	const double fee;
+	std::string txid; // cached on construction, never sent over the wire
+	const Address sendAddr;
+	const std::vector<Address> recieveAddr;
+	const std::vector<Amount> ammount; // base units, contiguous for Amounts::sum
+	const Amount fee;
 	const unsigned short locktime;
 	const float version;
+
+	/* Wire layout: tSize | counts | region sizes | scalars | regions. NOTE: txid is NOT serialized,
+	   it is the digest of this very encoding */
+	using Wire = serial::Layout<transactions,
+		serial::Count<&transactions::ammount>, serial::Count<&transactions::recieveAddr>,
+		serial::Count<&transactions::delegates>, serial::Count<&transactions::delegateID>,
+		serial::Count<&transactions::votesQueue>,
+		serial::Extent<&transactions::sendAddr>, serial::Extent<&transactions::ammount>,
+		serial::Extent<&transactions::recieveAddr>, serial::Extent<&transactions::delegates>,
+		serial::Extent<&transactions::delegateID>, serial::Extent<&transactions::votesQueue>,
+		serial::Field<&transactions::locktime>, serial::Field<&transactions::version>,
+		serial::Field<&transactions::fee>, serial::Field<&transactions::timestamp>,
+		serial::Field<&transactions::sendAddr>, serial::Field<&transactions::ammount>,
+		serial::Field<&transactions::recieveAddr>, serial::Field<&transactions::delegates>,
+		serial::Field<&transactions::delegateID>, serial::Field<&transactions::votesQueue>>;
 };
\ No newline at end of file
@@ -22,12 +22,16 @@ unsigned long long util::TimeStamp(){
 #include <vector>
 
 bool util::shaHash(const std::string &message, std::vector<unsigned char> &hash) {
+    return shaHash(reinterpret_cast<const unsigned char*>(message.data()), message.size(), hash);
+}
+
+bool util::shaHash(const unsigned char* data, const size_t size, std::vector<unsigned char> &hash) {
     hash.resize(SHA512_DIGEST_LENGTH);
     EVP_MD_CTX *mdctx = EVP_MD_CTX_new();
     if (!mdctx) return false;
 
     if (EVP_DigestInit_ex(mdctx, EVP_sha3_512(), nullptr) &&
-        EVP_DigestUpdate(mdctx, message.data(), message.size()) &&
+        EVP_DigestUpdate(mdctx, data, size) &&
         EVP_DigestFinal_ex(mdctx, hash.data(), nullptr)) {
         EVP_MD_CTX_free(mdctx);
         return true;
@@ -38,7 +42,7 @@ bool util::shaHash(const std::string &message, std::vector<unsigned char> &hash)
 }
 
 bool util::ripemd(const std::vector<unsigned char> &input, std::vector<unsigned char> &hash){
-    hash.resize(RIPEMD160_DIGEST_LENGTH * 2); // RIPEMD-320 is twice the length of RIPEMD-160
+    hash.resize(RIPEMD160_DIGEST_LENGTH); // 20 byte digest, the binary wallet address
     EVP_MD_CTX *mdctx = EVP_MD_CTX_new();
     if (!mdctx) return false;
 
@@ -53,6 +57,39 @@ bool util::ripemd(const std::vector<unsigned char> &input, std::vector<unsigned
     return false;
 }
 
+std::string util::toHex(const unsigned char* bytes, size_t size) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string out(size * 2, '0');
+    for (size_t i = 0; i < size; i++) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+    return out;
+}
+
+bool util::fromHex(const std::string& hex, std::vector<unsigned char>& out) {
+    auto nibble = [](const char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    std::vector<unsigned char> bytes(hex.size() / 2);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        const int hi = nibble(hex[2 * i]), lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    out = std::move(bytes);
+    return true;
+}
+
 std::string util::genRandNum(){
     /* Create a random device and a Mersenne Twister engine */
     std::random_device rd;
@@ -79,41 +116,167 @@ std::string util::getPasswordFromUser(){
 }
 
 
-std::string util::base58_encode(const unsigned char* bytes, size_t size) {
-    const std::string base58_chars = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-    std::string result;
+/*
+ * Base58 works on big numbers held in 32-bit limbs instead of one byte /
+ * one digit at a time: encoding folds 4 input bytes per step into limbs of
+ * base 58^5, decoding folds 5 digits per step into limbs of base 2^32.
+ * That is ~20x fewer inner loop iterations than the byte by byte method.
+ */
+namespace {
+    const char* BASE58_CHARS = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    constexpr uint64_t BASE58_POW5 = 656356768ULL; // 58^5
 
-    /* Convert big-endian bytes to little-endian */
-    std::vector<unsigned char> temp(bytes, bytes + size);
-    std::copy(bytes, bytes + size, temp.begin());
+    /* Reverse lookup, -1 for characters outside the alphabet */
+    constexpr std::array<int8_t, 128> BASE58_MAP = [] {
+        std::array<int8_t, 128> map{};
+        map.fill(-1);
+        constexpr std::string_view chars = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+        for (size_t i = 0; i < chars.size(); i++) {
+            map[static_cast<unsigned char>(chars[i])] = static_cast<int8_t>(i);
+        }
+        return map;
+    }();
+}
 
-    /* Count leading zeros */
+std::string util::base58_encode(const unsigned char* bytes, size_t size) {
+    /* Count leading zeros, each one maps to a leading '1' */
     size_t leadingZeros = 0;
-    while (leadingZeros < temp.size() && temp[leadingZeros] == 0) {
+    while (leadingZeros < size && bytes[leadingZeros] == 0) {
         leadingZeros++;
     }
 
-    /* Allocate enough space in big-endian base58 representation */
-    std::vector<unsigned char> base58(size * 138 / 100 + 1, 0); // log(256) / log(58), rounded up
-
-    /* Process the bytes */
-    size_t index = base58.size();
-    for (size_t i = 0; i < temp.size(); ++i) {
-        unsigned int carry = temp[i];
-        for (size_t j = base58.size(); j > 0; --j) {
-            carry += 256 * base58[j - 1];
-            base58[j - 1] = carry % 58;
-            carry /= 58;
+    /* Little-endian limbs, each holding 5 base58 digits */
+    std::vector<uint32_t> limbs;
+    limbs.reserve((size - leadingZeros) * 138 / 500 + 2); // log(256) / log(58) / 5
+
+    /* Fold the input in 4 byte chunks, the first chunk takes the remainder */
+    size_t i = leadingZeros;
+    size_t chunk = (size - leadingZeros) % 4;
+    if (chunk == 0) chunk = 4;
+    while (i < size) {
+        uint64_t carry = 0;
+        for (size_t k = 0; k < chunk; k++) {
+            carry = (carry << 8) | bytes[i + k];
+        }
+        const unsigned shift = static_cast<unsigned>(chunk * 8);
+        for (uint32_t& limb : limbs) {
+            carry += static_cast<uint64_t>(limb) << shift;
+            limb = static_cast<uint32_t>(carry % BASE58_POW5);
+            carry /= BASE58_POW5;
         }
+        while (carry > 0) {
+            limbs.push_back(static_cast<uint32_t>(carry % BASE58_POW5));
+            carry /= BASE58_POW5;
+        }
+        i += chunk;
+        chunk = 4;
     }
 
-    /* Preserve leading zeros in base58 result */
-    result.reserve(leadingZeros + base58.size());
-    result.assign(leadingZeros, '1');
-    for (unsigned char c : base58) {
-        if (c != 0) {
-            result.push_back(base58_chars[c]);
+    /* Expand limbs to digits, most significant first */
+    std::string digits;
+    digits.reserve(limbs.size() * 5);
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        uint32_t limb = *it;
+        char group[5];
+        for (int d = 4; d >= 0; d--) {
+            group[d] = BASE58_CHARS[limb % 58];
+            limb /= 58;
         }
+        digits.append(group, 5);
+    }
+
+    /* Strip padding zeros of the top limb (they are not leading zero bytes) */
+    const size_t firstNonZero = digits.find_first_not_of('1');
+    std::string result(leadingZeros, '1');
+    if (firstNonZero != std::string::npos) {
+        result.append(digits, firstNonZero, std::string::npos);
     }
     return result;
-}
\ No newline at end of file
+}
+
+bool util::base58_decode(const std::string& str, std::vector<unsigned char>& out) {
+    out.clear();
+
+    /* Leading '1's are leading zero bytes */
+    size_t leadingOnes = 0;
+    while (leadingOnes < str.size() && str[leadingOnes] == '1') {
+        leadingOnes++;
+    }
+
+    /* Little-endian 32-bit limbs */
+    std::vector<uint32_t> limbs;
+    limbs.reserve((str.size() - leadingOnes) * 733 / 3200 + 2); // log(58) / log(256) / 4
+
+    /* Fold the digits in groups of 5, the first group takes the remainder */
+    size_t i = leadingOnes;
+    size_t group = (str.size() - leadingOnes) % 5;
+    if (group == 0) group = 5;
+    while (i < str.size()) {
+        uint64_t carry = 0;
+        uint64_t mul = 1;
+        for (size_t k = 0; k < group; k++) {
+            const auto c = static_cast<unsigned char>(str[i + k]);
+            if (c >= BASE58_MAP.size() || BASE58_MAP[c] < 0) {
+                logCall("UTIL", "base58_decode()", false, "Invalid Base58 Character");
+                return false;
+            }
+            carry = carry * 58 + static_cast<uint64_t>(BASE58_MAP[c]);
+            mul *= 58;
+        }
+        for (uint32_t& limb : limbs) {
+            carry += static_cast<uint64_t>(limb) * mul;
+            limb = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        while (carry > 0) {
+            limbs.push_back(static_cast<uint32_t>(carry));
+            carry >>= 32;
+        }
+        i += group;
+        group = 5;
+    }
+
+    /* Limbs to big-endian bytes, without the top limb's zero padding */
+    out.assign(leadingOnes, 0);
+    bool started = false;
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            const auto b = static_cast<unsigned char>(*it >> shift);
+            if (started || b != 0) {
+                out.push_back(b);
+                started = true;
+            }
+        }
+    }
+    return true;
+}
+
+std::string util::base58check_encode(const unsigned char* bytes, size_t size) {
+    std::vector<unsigned char> hash;
+    if (!shaHash(std::string(reinterpret_cast<const char*>(bytes), size), hash)) {
+        logCall("UTIL", "base58check_encode()", false, "Checksum Hash Failed");
+        return "";
+    }
+
+    std::vector<unsigned char> payload(bytes, bytes + size);
+    payload.insert(payload.end(), hash.begin(), hash.begin() + 4);
+    return base58_encode(payload.data(), payload.size());
+}
+
+bool util::base58check_decode(const std::string& str, std::vector<unsigned char>& out) {
+    if (!base58_decode(str, out) || out.size() < 4) {
+        return false;
+    }
+
+    const size_t size = out.size() - 4;
+    std::vector<unsigned char> hash;
+    if (!shaHash(std::string(reinterpret_cast<const char*>(out.data()), size), hash) ||
+        std::memcmp(hash.data(), out.data() + size, 4) != 0) {
+        logCall("UTIL", "base58check_decode()", false, "Checksum Mismatch");
+        out.clear();
+        return false;
+    }
+
+    out.resize(size);
+    return true;
+}
@@ -43,6 +43,7 @@
 #include <ctime>
 #include <fstream>
 #include <memory>
+#include <array>
 #include <algorithm> // For std::copy
 #include <cstring> // For std::mem-copy
 #include <nlohmann/json.hpp>
@@ -55,6 +56,7 @@ public:
 	/* Time Stamp Function, Sets current timestamp */
 	static unsigned long long TimeStamp();
 	static bool shaHash(const std::string &message, std::vector<unsigned char> &hash);
+	static bool shaHash(const unsigned char* data, size_t size, std::vector<unsigned char> &hash);
 	static bool ripemd(const std::vector<unsigned char> &input, std::vector<unsigned char> &hash);
 
 
@@ -155,6 +157,10 @@ public:
 				<< (success ? "SUCCESS" : "FAIL") << " | " << error << std::endl;
 	}
 
+	/* Lower case hex encoding of raw bytes (digests, ids) */
+	static std::string toHex(const unsigned char* bytes, size_t size);
+	static bool fromHex(const std::string& hex, std::vector<unsigned char>& out);
+
 	/* Random Number Generator Function, Generates 17 Digit Random Number */
 	static std::string genRandNum();
 
@@ -163,6 +169,11 @@ public:
 
 	/* Base58 Encoding, Commonly used so letters/numbers don't get confused */
 	static std::string base58_encode(const unsigned char* bytes, size_t size);
+	static bool base58_decode(const std::string& str, std::vector<unsigned char>& out);
+
+	/* Base58Check, payload followed by the first 4 bytes of its SHA3-512 hash */
+	static std::string base58check_encode(const unsigned char* bytes, size_t size);
+	static bool base58check_decode(const std::string& str, std::vector<unsigned char>& out);
 
 };
 